@@ -0,0 +1,206 @@
+/* *****************************************************************************
+ * Module: Debounce
+ *
+ * File Name: Debounce.c
+ *
+ * Description: Source file for the debounce service of the EXTI lines (push buttons)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Debounce.h"
+#include "GPT.h"
+#include "Gpio.h"
+#include "Macros.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* State of one line */
+typedef struct {
+	uint32 LastEdge;       /* clock ticks (low 32 bits) of the last edge */
+	uint32 WindowTicks;    /* quiet time before a confirmation */
+	Debounce_CallbackType Callback;
+	uint8 Port;
+	uint8 Level;           /* last confirmed level */
+} Debounce_LineType;
+
+static Debounce_LineType debounce_line[DEBOUNCE_NUM_OF_LINES];
+
+/* Lines configured / waiting for their confirmation (bit n : line n) */
+static uint16 debounce_configured;
+static volatile uint16 debounce_pending;
+
+/* DEBOUNCE_TIMER is running, till the clock ticks of debounce_deadline */
+static volatile boolean debounce_armed;
+static uint32 debounce_deadline;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Low 32 bits of the monotonic clock, enough for the differences of the debounce windows */
+static uint32 Debounce_Now(void)
+{
+	return (uint32)GPT_GetTicks64();
+}
+
+/* (Re)start DEBOUNCE_TIMER to expire after Ticks clock ticks (rounded up to a whole ms) */
+static void Debounce_Arm(uint32 Now, uint32 Ticks)
+{
+	debounce_deadline = Now + Ticks;
+	debounce_armed = TRUE;
+	/* a running countdown is stopped first : its counter restarts from 0 */
+	GPT_EndTimer(DEBOUNCE_TIMER);
+	GPT_StartTimer(DEBOUNCE_TIMER, (Ticks + GPT_CLOCK_TICKS_PER_MS - 1) / GPT_CLOCK_TICKS_PER_MS);
+}
+
+/* Expiry of DEBOUNCE_TIMER : confirm the quiet lines, wait again for the others */
+static void Debounce_Expiry(void)
+{
+	uint32 now = Debounce_Now();
+	uint32 next = 0xFFFFFFFFUL;
+	uint8 line;
+
+	debounce_armed = FALSE;
+	for (line = 0; (line < DEBOUNCE_NUM_OF_LINES) && (debounce_pending != 0); line++)
+	{
+		Debounce_LineType * state = &debounce_line[line];
+		uint32 quiet;
+
+		if (BIT_IS_CLEAR(debounce_pending, line))
+		{
+			continue;
+		}
+		quiet = now - state->LastEdge;
+		if (quiet >= state->WindowTicks)
+		{
+			uint16 snapshot;
+
+			/* Quiet for the whole window : sample the pin again */
+			CLEAR_BIT(debounce_pending, line);
+			if ((Gpio_ReadPortSnapshot(state->Port, (uint16)(1U << line), &snapshot) == OK) &&
+				(((snapshot != 0) ? HIGH : LOW) != state->Level))
+			{
+				state->Level = (snapshot != 0) ? HIGH : LOW;
+				if (state->Callback != 0)
+				{
+					state->Callback(line, state->Level);
+				}
+			}
+		}
+		else if ((state->WindowTicks - quiet) < next)
+		{
+			next = state->WindowTicks - quiet;
+		}
+	}
+	if (debounce_pending != 0)
+	{
+		Debounce_Arm(now, next);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Debounce_Init
+ * Input : void
+ * Output : uint8 DEBOUNCE_OK, DEBOUNCE_NOK if DEBOUNCE_TIMER is owned by another driver
+ * Description :
+ * Release all the lines and take DEBOUNCE_TIMER for the confirmations.
+ */
+uint8 Debounce_Init(void){
+	debounce_configured = 0;
+	debounce_pending = 0;
+	debounce_armed = FALSE;
+
+	if (GPT_Init(DEBOUNCE_TIMER) != GPT_OK)
+	{
+		return DEBOUNCE_NOK;
+	}
+	GPT_SetCallback(DEBOUNCE_TIMER, Debounce_Expiry);
+	return DEBOUNCE_OK;
+}
+
+/*
+ * Function : Debounce_ConfigLine
+ * Input : PortName, LineNum, WindowMs, Callback
+ * Output : void
+ * Description :
+ * Debounce the line : a level is confirmed after WindowMs without any edge.
+ * The current level of the pin is taken as the confirmed level, a WindowMs of 0 is taken as 1 ms.
+ * Callback can be 0 when the level is polled with Debounce_GetLevel.
+ *  If the input line is not correct, The function will not handle the request.
+ */
+void Debounce_ConfigLine(uint8 PortName, uint8 LineNum, uint32 WindowMs, Debounce_CallbackType Callback){
+	Debounce_LineType * state;
+	uint16 snapshot = 0;
+
+	if (LineNum >= DEBOUNCE_NUM_OF_LINES)
+	{
+		return;
+	}
+	state = &debounce_line[LineNum];
+
+	CLEAR_BIT(debounce_configured, LineNum);
+	CLEAR_BIT(debounce_pending, LineNum);
+	(void)Gpio_ReadPortSnapshot(PortName, (uint16)(1U << LineNum), &snapshot);
+	state->Port = PortName;
+	state->Level = (snapshot != 0) ? HIGH : LOW;
+	state->WindowTicks = ((WindowMs != 0) ? WindowMs : 1) * GPT_CLOCK_TICKS_PER_MS;
+	state->Callback = Callback;
+	SET_BIT(debounce_configured, LineNum);
+}
+
+/*
+ * Function : Debounce_OnEdge
+ * Input : LineNum
+ * Output : void
+ * Description :
+ * Timestamp an edge of the line, to be called from its EXTI interrupt (Exti_SetHandler).
+ * The edges of the lines that are not configured are ignored.
+ */
+void Debounce_OnEdge(uint8 LineNum){
+	uint32 now;
+
+	if ((LineNum >= DEBOUNCE_NUM_OF_LINES) || BIT_IS_CLEAR(debounce_configured, LineNum))
+	{
+		return;
+	}
+	now = Debounce_Now();
+	debounce_line[LineNum].LastEdge = now;
+	SET_BIT(debounce_pending, LineNum);
+
+	/* The timer is only restarted when this confirmation is the nearest one */
+	if ((debounce_armed == FALSE) || ((sint32)((now + debounce_line[LineNum].WindowTicks) - debounce_deadline) < 0))
+	{
+		Debounce_Arm(now, debounce_line[LineNum].WindowTicks);
+	}
+}
+
+/*
+ * Function : Debounce_GetLevel
+ * Input : LineNum
+ * Output : uint8 last confirmed level of the line (LOW or HIGH)
+ */
+uint8 Debounce_GetLevel(uint8 LineNum){
+	if (LineNum >= DEBOUNCE_NUM_OF_LINES)
+	{
+		return LOW;
+	}
+	return debounce_line[LineNum].Level;
+}
+
+/*
+ * Function : Debounce_IsBusy
+ * Input : void
+ * Output : TRUE while a line is waiting for its confirmation, FALSE otherwise
+ */
+boolean Debounce_IsBusy(void){
+	return (debounce_pending != 0) ? TRUE : FALSE;
+}
@@ -0,0 +1,108 @@
+/* *****************************************************************************
+ * Module: Debounce
+ *
+ * File Name: Debounce.h
+ *
+ * Description: Header file for the debounce service of the EXTI lines (push buttons)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef DEBOUNCE_H_
+#define DEBOUNCE_H_
+
+#include "Std_Types.h"
+#include "GPT.h"
+
+/* Debounce Documentation */
+/* Timestamped debounce of the EXTI lines 0 .. 15
+ * Each edge of a line is only timestamped with the GPT monotonic clock (TIM5), the line is confirmed
+ * when it stayed quiet for its debounce window : its pin is sampled again in IDR and the new level
+ * is reported if it differs from the last confirmed level. The chatter inside the window is dropped.
+ * 1. Start the clock by calling GPT_ClockInit(), then initialize the service by calling Debounce_Init().
+ * 2. Configure the EXTI line on both edges (Exti_Init( port, line, RISING_FALLING_EDGE )),
+ *    then call Debounce_ConfigLine( port, line, window in ms, callback ).
+ * 3. Register Debounce_OnEdge as the EXTI handler of the line (Exti_SetHandler( line, Debounce_OnEdge )).
+ * 4. Get the confirmed levels from the callback or by calling Debounce_GetLevel( line ).
+ * 5. Check that no line is waiting for its confirmation by calling Debounce_IsBusy()
+ *    (the debounce timer does not run in Stop mode).
+ * An edge costs one clock read and one bit set, one timer (DEBOUNCE_TIMER) serves all the lines :
+ * it is only started for the nearest confirmation, the lines are scanned only at its expiry.
+ * The EXTI interrupts of the lines and the DEBOUNCE_TIMER interrupt must have the same priority.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+/* Countdown timer of the confirmations */
+#define DEBOUNCE_TIMER  GPT_TIM2
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define DEBOUNCE_NUM_OF_LINES  16
+
+/* Debounce_Init status */
+#define DEBOUNCE_OK   0
+#define DEBOUNCE_NOK  1
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Confirmed level change, called from the DEBOUNCE_TIMER interrupt with the line and its new level */
+typedef void (*Debounce_CallbackType)(uint8 LineNum, uint8 Level);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Debounce_Init
+ * Input : void
+ * Output : uint8 DEBOUNCE_OK, DEBOUNCE_NOK if DEBOUNCE_TIMER is owned by another driver
+ * Description :
+ * Release all the lines and take DEBOUNCE_TIMER for the confirmations.
+ */
+uint8 Debounce_Init(void);
+
+/*
+ * Function : Debounce_ConfigLine
+ * Input : PortName, LineNum, WindowMs, Callback
+ * Output : void
+ * Description :
+ * Debounce the line : a level is confirmed after WindowMs without any edge.
+ * The current level of the pin is taken as the confirmed level, a WindowMs of 0 is taken as 1 ms.
+ * Callback can be 0 when the level is polled with Debounce_GetLevel.
+ *  If the input line is not correct, The function will not handle the request.
+ */
+void Debounce_ConfigLine(uint8 PortName, uint8 LineNum, uint32 WindowMs, Debounce_CallbackType Callback);
+
+/*
+ * Function : Debounce_OnEdge
+ * Input : LineNum
+ * Output : void
+ * Description :
+ * Timestamp an edge of the line, to be called from its EXTI interrupt (Exti_SetHandler).
+ * The edges of the lines that are not configured are ignored.
+ */
+void Debounce_OnEdge(uint8 LineNum);
+
+/*
+ * Function : Debounce_GetLevel
+ * Input : LineNum
+ * Output : uint8 last confirmed level of the line (LOW or HIGH)
+ */
+uint8 Debounce_GetLevel(uint8 LineNum);
+
+/*
+ * Function : Debounce_IsBusy
+ * Input : void
+ * Output : TRUE while a line is waiting for its confirmation, FALSE otherwise
+ */
+boolean Debounce_IsBusy(void);
+
+#endif /* DEBOUNCE_H_ */
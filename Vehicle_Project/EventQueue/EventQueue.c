@@ -0,0 +1,117 @@
+/* *****************************************************************************
+ * Module: EventQueue
+ *
+ * File Name: EventQueue.c
+ *
+ * Description: Source file for the events queue from the interrupts to the main loop
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "EventQueue.h"
+#include "Cpu.h"
+#include "NVIC.h"
+#include "Power.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+#define EVENTQUEUE_MASK  (EVENTQUEUE_SIZE - 1)
+
+static EventQueue_EventType eventqueue_buffer[EVENTQUEUE_SIZE];
+
+/* Free running indexes (modulo 256) : head written by the producers (serialized), tail written by
+ * the consumer, the queue holds head - tail events */
+static volatile uint8 eventqueue_head;
+static volatile uint8 eventqueue_tail;
+
+/* Events dropped on a full queue, written by the producer */
+static volatile uint32 eventqueue_overflows;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : EventQueue_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Empty the queue and clear the overflow counter.
+ */
+void EventQueue_Init(void){
+	eventqueue_head = 0;
+	eventqueue_tail = 0;
+	eventqueue_overflows = 0;
+}
+
+/*
+ * Function : EventQueue_Post
+ * Input : Event
+ * Output : uint8 EVENTQUEUE_OK, EVENTQUEUE_FULL if the queue is full (the event is dropped and counted)
+ * Description :
+ * Add a copy of the event at the head of the queue and wake the main loop, called by the producer only.
+ */
+uint8 EventQueue_Post(const EventQueue_EventType * Event){
+	/* one producer at a time : the other producers are held, not the higher interrupts */
+	uint32 saved = Nvic_EnterCritical(EVENTQUEUE_PRODUCER_PRIORITY);
+	uint8 head = eventqueue_head;
+
+	if ((uint8)(head - eventqueue_tail) >= EVENTQUEUE_SIZE)
+	{
+		eventqueue_overflows++;
+		Nvic_ExitCritical(saved);
+		return EVENTQUEUE_FULL;
+	}
+	eventqueue_buffer[head & EVENTQUEUE_MASK] = *Event;
+	/* the event is written before it is published to the consumer */
+	CPU_MEMORY_BARRIER();
+	eventqueue_head = (uint8)(head + 1);
+	Nvic_ExitCritical(saved);
+	Power_Wakeup();
+	return EVENTQUEUE_OK;
+}
+
+/*
+ * Function : EventQueue_Get
+ * Input : Event
+ * Output : TRUE if the oldest event was copied to *Event and removed, FALSE if the queue is empty
+ * Description :
+ * Take the event at the tail of the queue, called by the consumer only.
+ */
+boolean EventQueue_Get(EventQueue_EventType * Event){
+	uint8 tail = eventqueue_tail;
+
+	if (tail == eventqueue_head)
+	{
+		return FALSE;
+	}
+	/* the head is read before the event it publishes */
+	CPU_MEMORY_BARRIER();
+	*Event = eventqueue_buffer[tail & EVENTQUEUE_MASK];
+	/* the event is read before its slot is given back to the producer */
+	CPU_MEMORY_BARRIER();
+	eventqueue_tail = (uint8)(tail + 1);
+	return TRUE;
+}
+
+/*
+ * Function : EventQueue_IsEmpty
+ * Input : void
+ * Output : TRUE if no event is waiting, FALSE otherwise
+ */
+boolean EventQueue_IsEmpty(void){
+	return (eventqueue_head == eventqueue_tail) ? TRUE : FALSE;
+}
+
+/*
+ * Function : EventQueue_GetOverflowCount
+ * Input : void
+ * Output : uint32 number of events dropped because the queue was full
+ */
+uint32 EventQueue_GetOverflowCount(void){
+	return eventqueue_overflows;
+}
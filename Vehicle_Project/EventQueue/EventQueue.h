@@ -0,0 +1,109 @@
+/* *****************************************************************************
+ * Module: EventQueue
+ *
+ * File Name: EventQueue.h
+ *
+ * Description: Header file for the events queue from the interrupts to the main loop
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#include "Std_Types.h"
+
+/* Event Queue Documentation */
+/* Single producer / single consumer ring buffer of typed events, without lock
+ * The producer is the interrupt level, the consumer is the main loop. The interrupts that post
+ * can have different priorities : a post holds the interrupts up to EVENTQUEUE_PRODUCER_PRIORITY
+ * (BASEPRI) for a few instructions, so the posts never interleave and higher interrupts still run.
+ * 1. Initialize the queue by calling EventQueue_Init() before enabling the producers.
+ * 2. Post an event from an interrupt by calling EventQueue_Post( event ),
+ *    the main loop is woken from its idle (Power_Wakeup).
+ * 3. Take the events in order from the main loop by calling EventQueue_Get( event ) till it returns FALSE.
+ * 4. Read the number of events dropped because the queue was full by calling EventQueue_GetOverflowCount().
+ * The producer only writes the head, the consumer only writes the tail : post and get never wait.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+/* Number of events, power of 2 (at most 128) : one press and one release of each EXTI line
+ * plus one expiry of each software timer can wait together */
+#define EVENTQUEUE_SIZE  64
+
+/* Highest preemption priority of the interrupts that post (lowest value) */
+#define EVENTQUEUE_PRODUCER_PRIORITY  2
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Events types */
+#define EVENTQUEUE_BUTTON  0   /* Id : EXTI line, Level : confirmed level of the button */
+#define EVENTQUEUE_TIMER   1   /* Id : software timer id */
+
+/* EventQueue_Post status */
+#define EVENTQUEUE_OK    0
+#define EVENTQUEUE_FULL  1
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct {
+	uint32 Timestamp;   /* GPT clock ticks (low 32 bits) of the event */
+	uint8 Type;         /* EVENTQUEUE_BUTTON, EVENTQUEUE_TIMER */
+	uint8 Id;           /* source of the event */
+	uint8 Level;        /* level of a button event */
+} EventQueue_EventType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : EventQueue_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Empty the queue and clear the overflow counter.
+ */
+void EventQueue_Init(void);
+
+/*
+ * Function : EventQueue_Post
+ * Input : Event
+ * Output : uint8 EVENTQUEUE_OK, EVENTQUEUE_FULL if the queue is full (the event is dropped and counted)
+ * Description :
+ * Add a copy of the event at the head of the queue and wake the main loop, called by the producer only.
+ */
+uint8 EventQueue_Post(const EventQueue_EventType * Event);
+
+/*
+ * Function : EventQueue_Get
+ * Input : Event
+ * Output : TRUE if the oldest event was copied to *Event and removed, FALSE if the queue is empty
+ * Description :
+ * Take the event at the tail of the queue, called by the consumer only.
+ */
+boolean EventQueue_Get(EventQueue_EventType * Event);
+
+/*
+ * Function : EventQueue_IsEmpty
+ * Input : void
+ * Output : TRUE if no event is waiting, FALSE otherwise
+ */
+boolean EventQueue_IsEmpty(void);
+
+/*
+ * Function : EventQueue_GetOverflowCount
+ * Input : void
+ * Output : uint32 number of events dropped because the queue was full
+ */
+uint32 EventQueue_GetOverflowCount(void);
+
+#endif /* EVENTQUEUE_H_ */
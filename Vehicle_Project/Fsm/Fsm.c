@@ -0,0 +1,133 @@
+/* *****************************************************************************
+ * Module: Fsm
+ *
+ * File Name: Fsm.c
+ *
+ * Description: Source file for the table driven state machine engine
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Fsm.h"
+
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* First transition of the current state for the event with a TRUE guard, 0 if none */
+static const Fsm_TransitionType * Fsm_Find(const Fsm_MachineType * Machine, uint8 Event)
+{
+	uint8 index;
+
+	for (index = 0; index < Machine->NumOfTransitions; index++)
+	{
+		const Fsm_TransitionType * transition = &Machine->Transitions[index];
+
+		if ((transition->State == Machine->Current) && (transition->Event == Event) &&
+			((transition->Guard == 0) || (transition->Guard() == TRUE)))
+		{
+			return transition;
+		}
+	}
+	return 0;
+}
+
+/* Take a transition : exit, action, entry (nothing but the action for an internal transition) */
+static void Fsm_Take(Fsm_MachineType * Machine, const Fsm_TransitionType * Transition)
+{
+	if ((Transition->Next != FSM_INTERNAL) && (Machine->States[Machine->Current].Exit != 0))
+	{
+		Machine->States[Machine->Current].Exit();
+	}
+	if (Transition->Action != 0)
+	{
+		Transition->Action();
+	}
+	if ((Transition->Next != FSM_INTERNAL) && (Transition->Next < Machine->NumOfStates))
+	{
+		Machine->Current = Transition->Next;
+		if (Machine->States[Machine->Current].Entry != 0)
+		{
+			Machine->States[Machine->Current].Entry();
+		}
+	}
+}
+
+/* Completion transitions after an entry, a chain is limited to the number of states (no endless loop) */
+static void Fsm_Complete(Fsm_MachineType * Machine)
+{
+	uint8 steps;
+
+	for (steps = 0; steps < Machine->NumOfStates; steps++)
+	{
+		const Fsm_TransitionType * transition = Fsm_Find(Machine, FSM_COMPLETION);
+
+		if ((transition == 0) || (transition->Next == FSM_INTERNAL))
+		{
+			return;
+		}
+		Fsm_Take(Machine, transition);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Fsm_Start
+ * Input : Machine, Initial
+ * Output : void
+ * Description :
+ * Enter the initial state (entry action and completion transitions).
+ *  If the input state is not correct, The function will not handle the request.
+ */
+void Fsm_Start(Fsm_MachineType * Machine, uint8 Initial){
+	if (Initial >= Machine->NumOfStates)
+	{
+		return;
+	}
+	Machine->Current = Initial;
+	if (Machine->States[Initial].Entry != 0)
+	{
+		Machine->States[Initial].Entry();
+	}
+	Fsm_Complete(Machine);
+}
+
+/*
+ * Function : Fsm_Dispatch
+ * Input : Machine, Event
+ * Output : TRUE if a transition took the event, FALSE otherwise (the do action of the state was run)
+ * Description :
+ * Run the event to completion : the transition, the entry of the next state and its completion transitions.
+ */
+boolean Fsm_Dispatch(Fsm_MachineType * Machine, uint8 Event){
+	const Fsm_TransitionType * transition = Fsm_Find(Machine, Event);
+
+	if (transition == 0)
+	{
+		if (Machine->States[Machine->Current].Do != 0)
+		{
+			Machine->States[Machine->Current].Do();
+		}
+		return FALSE;
+	}
+	Fsm_Take(Machine, transition);
+	if (transition->Next != FSM_INTERNAL)
+	{
+		Fsm_Complete(Machine);
+	}
+	return TRUE;
+}
+
+/*
+ * Function : Fsm_GetState
+ * Input : Machine
+ * Output : uint8 current state of the machine
+ */
+uint8 Fsm_GetState(const Fsm_MachineType * Machine){
+	return Machine->Current;
+}
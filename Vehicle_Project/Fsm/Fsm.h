@@ -0,0 +1,107 @@
+/* *****************************************************************************
+ * Module: Fsm
+ *
+ * File Name: Fsm.h
+ *
+ * Description: Header file for the table driven state machine engine
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef FSM_H_
+#define FSM_H_
+
+#include "Std_Types.h"
+
+/* Fsm Documentation */
+/* State x event transitions table with entry, exit and do actions (run to completion)
+ * A machine is a const table of states (entry, exit and do actions) and a const table of transitions
+ * (state, event, guard, action, next state). The outputs and the timers of a state are set by its
+ * entry action and released by its exit action : they change only on the transitions.
+ * 1. Describe the states and the transitions in const tables, then start the machine in its initial
+ *    state by calling Fsm_Start( machine, state ) : the entry action of the state is run.
+ * 2. Give each event to the machine by calling Fsm_Dispatch( machine, event ) :
+ *    the first transition of the current state for the event whose guard is TRUE is taken
+ *    (exit action, transition action, entry action of the next state). An internal transition
+ *    (next state FSM_INTERNAL) only runs its action. The do action of the state is run when no
+ *    transition takes the event.
+ * 3. After each entry the completion transitions (event FSM_COMPLETION) of the new state are checked :
+ *    a state left at once by a guard does not wait for another event.
+ * 4. Read the current state by calling Fsm_GetState( machine ).
+ * The actions run in the caller context, a machine is driven from one context only.
+ *  */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Event checked after each entry (transitions without event) */
+#define FSM_COMPLETION  0xFE
+
+/* Next state of an internal transition : action only, no exit and no entry */
+#define FSM_INTERNAL    0xFF
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef void (*Fsm_ActionType)(void);
+typedef boolean (*Fsm_GuardType)(void);
+
+/* Actions of a state (0 : no action), indexed by the state number */
+typedef struct {
+	Fsm_ActionType Entry;   /* on entering the state */
+	Fsm_ActionType Exit;    /* on leaving the state */
+	Fsm_ActionType Do;      /* on each event of the state taken by no transition */
+} Fsm_StateType;
+
+/* One row of the transitions table */
+typedef struct {
+	uint8 State;            /* current state */
+	uint8 Event;            /* event, FSM_COMPLETION : checked after the entry */
+	Fsm_GuardType Guard;    /* condition of the transition (0 : always) */
+	Fsm_ActionType Action;  /* run between the exit and the entry (0 : no action) */
+	uint8 Next;             /* next state, FSM_INTERNAL : no state change */
+} Fsm_TransitionType;
+
+/* A machine : its tables and its current state */
+typedef struct {
+	const Fsm_StateType * States;
+	uint8 NumOfStates;
+	const Fsm_TransitionType * Transitions;
+	uint8 NumOfTransitions;
+	uint8 Current;
+} Fsm_MachineType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Fsm_Start
+ * Input : Machine, Initial
+ * Output : void
+ * Description :
+ * Enter the initial state (entry action and completion transitions).
+ *  If the input state is not correct, The function will not handle the request.
+ */
+void Fsm_Start(Fsm_MachineType * Machine, uint8 Initial);
+
+/*
+ * Function : Fsm_Dispatch
+ * Input : Machine, Event
+ * Output : TRUE if a transition took the event, FALSE otherwise (the do action of the state was run)
+ * Description :
+ * Run the event to completion : the transition, the entry of the next state and its completion transitions.
+ */
+boolean Fsm_Dispatch(Fsm_MachineType * Machine, uint8 Event);
+
+/*
+ * Function : Fsm_GetState
+ * Input : Machine
+ * Output : uint8 current state of the machine
+ */
+uint8 Fsm_GetState(const Fsm_MachineType * Machine);
+
+#endif /* FSM_H_ */
@@ -11,33 +11,254 @@
 
 #include "GPT.h"
 #include "GPT_Private.h"
+#include "NVIC.h"
+#include "NVIC_Private.h"
 #include "Rcc.h"
+#include "Cpu.h"
+#include "Latency.h"
 #include "Macros.h"
 
 
 /*******************************************************************************
  *                      Global Variables   	                                   *
  *******************************************************************************/
-uint8 g_overflow_flag;
 
+/* State of one timer instance */
+typedef struct {
+	GPT_IrqHandlerType Owner;     /* handler of the timer interrupt, 0 : free timer */
+	GPT_CallbackType Callback;    /* expiry callback of the countdown */
+	volatile uint8 Expired;       /* expiry latched by the interrupt, not yet reported by GPT_CheckTimeIsElapsed */
+	uint8 OverflowFlag;           /* INITIAL_STATE / NO_OVERFLOW / OVERFLOW */
+} GPT_InstanceType;
+
+static GPT_InstanceType gpt_instance[GPT_NUM_OF_TIMERS];
+
+/* Latency probe of each timer interrupt (kept when the owner changes) */
+static uint8 gpt_probe[GPT_NUM_OF_TIMERS] = { GPT_NO_PROBE, GPT_NO_PROBE, GPT_NO_PROBE, GPT_NO_PROBE };
+
+/* Clock, interrupt and counter size of each timer */
+static const Rcc_PeripheralIdType gpt_rcc[GPT_NUM_OF_TIMERS] = { RCC_TIM2, RCC_TIM3, RCC_TIM4, RCC_TIM5 };
+static const uint8 gpt_irq[GPT_NUM_OF_TIMERS] = { TIM2_IRQ_POSITION, TIM3_IRQ_POSITION, TIM4_IRQ_POSITION, TIM5_IRQ_POSITION };
+static const uint32 gpt_max_ticks[GPT_NUM_OF_TIMERS] = { 0xFFFFFFFFUL, 0xFFFFUL, 0xFFFFUL, 0xFFFFFFFFUL };
+
+/* High 32 bits of the clock, counted by the TIM5 update interrupt */
+static volatile uint32 gpt_clock_high = 0;
+
+/* Alarm requested with a time already reached : the TIM5 interrupt is pended by software */
+static volatile uint8 gpt_alarm_forced = FALSE;
+
+static GPT_CallbackType gpt_alarm_callback = 0;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Timer ticks to ms, rounded up when Up is TRUE */
+static unsigned long int GPT_TicksToMs(uint32 Ticks, boolean Up)
+{
+	return Up ? ((Ticks / GPT_TICKS_PER_MS) + (((Ticks % GPT_TICKS_PER_MS) != 0) ? 1 : 0)) : (Ticks / GPT_TICKS_PER_MS);
+}
+
+/* Interrupt of a countdown timer : the counter is stopped by the one pulse mode, latch the expiry.
+ * The expiry is latched while the timer runs (NO_OVERFLOW) or already latched by GPT_StartTimer(0),
+ * a late interrupt after GPT_EndTimer is dropped */
+static void GPT_CountdownIrq(uint8 Timer)
+{
+	GPT_InstanceType * instance = &gpt_instance[Timer];
+
+	/* clear the update flag (the status flags are cleared by writing 0) */
+	GPT_GetRegisters(Timer)->SR = (uint32)~(1UL << 0);
+	if ((instance->OverflowFlag != NO_OVERFLOW) && (instance->Expired == FALSE))
+	{
+		return;
+	}
+	instance->Expired = TRUE;
+	instance->OverflowFlag = OVERFLOW;
+	if (instance->Callback != 0)
+	{
+		instance->Callback();
+	}
+}
+
+/* Interrupt of the monotonic clock (TIM5) */
+static void GPT_ClockIrq(uint8 Timer)
+{
+	TimxType * timer = GPT_GetRegisters(Timer);
+	uint32 flags = timer->SR;
+
+	/* Overflow of the low 32 bits : count it in the high 32 bits */
+	if (BIT_IS_SET(flags,0))
+	{
+		/* The flag and the high 32 bits change together : an interrupt of higher priority
+		 * reading the clock sees the overflow either pending or counted, never lost */
+		CPU_DISABLE_INTERRUPTS();
+		timer->SR = (uint32)~(1UL << 0);
+		gpt_clock_high++;
+		/* read back : the flag is cleared in the timer before the interrupts are enabled again */
+		(void)timer->SR;
+		CPU_ENABLE_INTERRUPTS();
+	}
+
+	/* Alarm : compare 1 match or alarm time already reached */
+	if (BIT_IS_SET(timer->DIER,1) && (BIT_IS_SET(flags,1) || (gpt_alarm_forced == TRUE)))
+	{
+		timer->SR = (uint32)~(1UL << 1);
+		gpt_alarm_forced = FALSE;
+		if (gpt_alarm_callback != 0)
+		{
+			gpt_alarm_callback();
+		}
+	}
+}
+
+/* Interrupt of a timer : call its owner, measured by the probe of the timer (ignored by Latency
+ * when it is GPT_NO_PROBE) */
+static void GPT_IrqDispatch(uint8 Timer)
+{
+	GPT_IrqHandlerType owner = gpt_instance[Timer].Owner;
+	uint8 probe = gpt_probe[Timer];
+
+	if (owner != 0)
+	{
+		Latency_Start(probe);
+		owner(Timer);
+		Latency_Stop(probe);
+	}
+	else
+	{
+		/* No owner : stop the interrupts of the timer */
+		GPT_GetRegisters(Timer)->DIER = 0;
+		GPT_GetRegisters(Timer)->SR = 0;
+	}
+}
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
+
 /*
- * Function : GPT_Init
- * Input : void
+ * Function : GPT_Claim
+ * Input : uint8 Timer, GPT_IrqHandlerType Handler
+ * Output : uint8 GPT_OK or GPT_NOK
+ * Description :
+ *  A function to take the ownership of a timer, its interrupt calls Handler with the timer instance.
+ *  It returns GPT_NOK if the timer is owned by another handler (claiming it again with the same handler is allowed).
+ */
+uint8 GPT_Claim(uint8 Timer, GPT_IrqHandlerType Handler){
+	if ((Timer >= GPT_NUM_OF_TIMERS) || (Handler == 0))
+	{
+		return GPT_NOK;
+	}
+	if ((gpt_instance[Timer].Owner != 0) && (gpt_instance[Timer].Owner != Handler))
+	{
+		return GPT_NOK;
+	}
+	gpt_instance[Timer].Owner = Handler;
+	return GPT_OK;
+}
+
+/*
+ * Function : GPT_Release
+ * Input : uint8 Timer
+ * Output : void
+ * Description :
+ *  A function to stop a timer and its interrupts and give it back.
+ */
+void GPT_Release(uint8 Timer){
+	TimxType * timer;
+
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
+	timer = GPT_GetRegisters(Timer);
+	CLEAR_BIT(timer->CR1,0);
+	timer->DIER = 0;
+	gpt_instance[Timer].Owner = 0;
+	gpt_instance[Timer].Callback = 0;
+}
+
+/*
+ * Function : GPT_GetRegisters
+ * Input : uint8 Timer
+ * Output : TimxType * registers of the timer
+ * Description :
+ *  A function to give the registers of a timer to the driver that owns it (GPT_Private.h).
+ */
+TimxType * GPT_GetRegisters(uint8 Timer){
+	switch (Timer)
+	{
+	case GPT_TIM2: return TIM2;
+	case GPT_TIM3: return TIM3;
+	case GPT_TIM4: return TIM4;
+	default:       return TIM5;
+	}
+}
+
+/*
+ * Function : GPT_GetPrescaler
+ * Input : uint32 TickFreq
+ * Output : uint32 value of the prescaler register
+ * Description :
+ *  A function to derive the prescaler of an APB1 timer for TickFreq ticks per second from the RCC clocks
+ *  (limited to the 16-bit prescaler).
+ */
+uint32 GPT_GetPrescaler(uint32 TickFreq){
+	Rcc_ClocksType clocks;
+	uint32 prescaler;
+
+	Rcc_GetClocks(&clocks);
+	prescaler = clocks.Apb1TimerClk / TickFreq;
+	if (prescaler == 0)
+	{
+		prescaler = 1;
+	}
+	else if (prescaler > 0x10000UL)
+	{
+		prescaler = 0x10000UL;
+	}
+	return prescaler - 1;
+}
+
+/*
+ * Function : GPT_Enable
+ * Input : uint8 Timer
  * Output : void
  * Description :
- * A function to initialize the GPT registers with the needed initial values
+ *  A function to enable the clock of a timer and its interrupt on NVIC, called by the driver that claimed it
+ *  before its configuration (the interrupt sources of the timer are enabled in DIER by the driver).
+ */
+void GPT_Enable(uint8 Timer){
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
+	Rcc_Enable(gpt_rcc[Timer]);
+	Nvic_EnableIrq(gpt_irq[Timer]);
+}
+
+/*
+ * Function : GPT_Init
+ * Input : uint8 Timer
+ * Output : uint8 GPT_OK or GPT_NOK
+ * Description :
+ * A function to initialize the registers of the timer with the needed initial values
  * to support the needed timing actions.
+ * It returns GPT_NOK if the timer is owned by another driver (PWM, monotonic clock).
  */
-void GPT_Init(void){
+uint8 GPT_Init(uint8 Timer){
+	TimxType * timer;
 
-	/*initialize Timer 2 register as Up-Counter to count 1 msec at one clock*/
+	if (GPT_Claim(Timer, GPT_CountdownIrq) != GPT_OK)
+	{
+		return GPT_NOK;
+	}
+	timer = GPT_GetRegisters(Timer);
+
+	/*initialize the Timer register as Up-Counter to count GPT_TICK_US at one clock*/
 
-	/* Enable Clock for TIMER 2*/
-	Rcc_Enable(RCC_TIM2);
+	/* Enable Clock for the TIMER and its interrupt on NVIC */
+	GPT_Enable(Timer);
 
 	/* Control Register 1 (CR1) Describtion:
         Set Counter Enable(CEN) bit at GPT Start Timer
@@ -51,61 +272,113 @@ void GPT_Init(void){
 	 */
 
 	/* set Update request source (URS) to generate update flag from overflow only*/
-	SET_BIT(TIM2->CR1,2);
-	/*set pre_scaler value to 1599 (16,000,000/15,999+1) */
-	TIM2->PSC = PSC_VALUE;
+	SET_BIT(timer->CR1,2);
+	/* set One pulse mode (OPM) : the counter stops at the overflow */
+	SET_BIT(timer->CR1,3);
+	/* pre_scaler derived from the timers clock (84 MHz / 8399+1 : 100 us) */
+	timer->PSC = GPT_GetPrescaler(1000000UL / GPT_TICK_US);
+	/* generate an update event (UG) to load the prescaler, PSC is only taken at the next update */
+	SET_BIT(timer->EGR,0);
 	/* enable update interrupt */
-	SET_BIT(TIM2->DIER,0);
-	g_overflow_flag = INITIAL_STATE;
+	SET_BIT(timer->DIER,0);
+	gpt_instance[Timer].OverflowFlag = INITIAL_STATE;
+	gpt_instance[Timer].Expired = FALSE;
+	return GPT_OK;
 }
 
 /*
  * Function : GPT_StartTimer
- * Input : unsigned long int OverFlowTicks
+ * Input : uint8 Timer, unsigned long int OverFlowTicks
  * Output : void
  * Description :
  *  A function to request the GPT to start and send its number of
- *  tickets before timer overflow and stop.
+ *  tickets before timer overflow and stop (1 ticket = 1 ms, counted in GPT_TICK_US).
+ *  TIM3 and TIM4 are 16-bit : their overflow is limited to 6553 ms (longer requests are clamped to
+ *  the counter range before the conversion to ticks, they never wrap to a short timer).
+ *  0 ms expires at once : the counter is not started, the expiry is latched and the timer
+ *  interrupt is pended so the callback runs from the interrupt as for any expiry.
  */
-void GPT_StartTimer(unsigned long int OverFlowTicks){
-	/*set overflow number to Auto Reload Register*/
-	TIM2->ARR = OverFlowTicks;
+void GPT_StartTimer(uint8 Timer, unsigned long int OverFlowTicks){
+	TimxType * timer;
+	uint32 ticks;
+
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
+	timer = GPT_GetRegisters(Timer);
+	/* drop an old update flag */
+	timer->SR = (uint32)~(1UL << 0);
+	if (OverFlowTicks == 0)
+	{
+		/* expired at once : counter stopped, expiry latched and interrupt pended for the callback */
+		CLEAR_BIT(timer->CR1,0);
+		timer->CNT = 0;
+		gpt_instance[Timer].Expired = TRUE;
+		gpt_instance[Timer].OverflowFlag = OVERFLOW;
+		NVIC->ISPR[gpt_irq[Timer] / 32] = (1UL << (gpt_irq[Timer] % 32));
+		return;
+	}
+	/* clamp in ms before the conversion : the product never wraps */
+	if (OverFlowTicks > (gpt_max_ticks[Timer] / GPT_TICKS_PER_MS))
+	{
+		ticks = gpt_max_ticks[Timer];
+	}
+	else
+	{
+		ticks = ((uint32)OverFlowTicks * GPT_TICKS_PER_MS) - 1;
+	}
+	/*set overflow number to Auto Reload Register (the overflow comes after ARR + 1 ticks)*/
+	timer->ARR = ticks;
+	gpt_instance[Timer].Expired = FALSE;
+	gpt_instance[Timer].OverflowFlag = NO_OVERFLOW;
 	/*Enable counter by setting Counter Enable bit Control Register 1 */
-	SET_BIT(TIM2->CR1,0);
-	g_overflow_flag = NO_OVERFLOW;
+	SET_BIT(timer->CR1,0);
 }
 
 /*
  * Function : GPT_EndTimer
- * Input : void
+ * Input : uint8 Timer
  * Output : void
  * Description :
  *  A function to End the GPT timer and clear the counter register to be able to start new timer
  */
-void GPT_EndTimer(void){
+void GPT_EndTimer(uint8 Timer){
+	TimxType * timer;
+
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
+	timer = GPT_GetRegisters(Timer);
 	/*stop the timer */
-	CLEAR_BIT(TIM2->CR1,0);
+	CLEAR_BIT(timer->CR1,0);
 	/* Clear counter register */
-	TIM2->CNT = 0;
-	g_overflow_flag = OVERFLOW;
+	timer->CNT = 0;
+	gpt_instance[Timer].Expired = FALSE;
+	gpt_instance[Timer].OverflowFlag = OVERFLOW;
 }
 
 /*
  * Function : GPT_CheckTimeIsElapsed
- * Input : void
+ * Input : uint8 Timer
  * Output : unsigned char
  * Description :
  * A function to return (1) if an overflow occurred after the last call of GPT_StartTimer
  * and (0) if no overflow occurred or GPT_StartTimer is not called from the last read.
  */
-unsigned char GPT_CheckTimeIsElapsed(void){
-	/* check if overflow occurred by Reading the UIF bit */
-	if(TIM2->CNT == (TIM2->ARR - 1))
+unsigned char GPT_CheckTimeIsElapsed(uint8 Timer){
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return TIMER_NOT_STARTED;
+	}
+	/* check if overflow occurred (latched by the update interrupt) */
+	if(gpt_instance[Timer].Expired == TRUE)
 	{
 		/*End the timer */
-		GPT_EndTimer();
+		GPT_EndTimer(Timer);
 		return OVERFLOW;
-	}else if(READ_BIT(TIM2->CR1,0) == 0){
+	}else if(READ_BIT(GPT_GetRegisters(Timer)->CR1,0) == 0){
 		return TIMER_NOT_STARTED;
 	}else{
 		return NO_OVERFLOW;
@@ -114,19 +387,19 @@ unsigned char GPT_CheckTimeIsElapsed(void){
 
 /*
  * Function : GPT_GetElapsedTime
- * Input : void
+ * Input : uint8 Timer
  * Output : unsigned long int
  * Description :
  *  A function to return number of elapsed ticks from the last call of the GPT_StartTimer,
  *  0 if it is not called and 0xffffffff if an overflow occurred.
  */
-unsigned long int GPT_GetElapsedTime(void){
+unsigned long int GPT_GetElapsedTime(uint8 Timer){
 
-	switch (GPT_CheckTimeIsElapsed())
+	switch (GPT_CheckTimeIsElapsed(Timer))
 	{
 	case NO_OVERFLOW:
 		// return elapsed time
-		return TIM2->CNT;
+		return GPT_TicksToMs(GPT_GetRegisters(Timer)->CNT, FALSE);
 		break;
 	case OVERFLOW:
 		return 0xffffffff;
@@ -142,19 +415,30 @@ unsigned long int GPT_GetElapsedTime(void){
 
 /*
  * Function : GPT_GetRemainingTime
- * Input : void
+ * Input : uint8 Timer
  * Output : unsigned long int
  * Description :
  *   A function to return number of remaining ticks till the overflow ticks passed to
  *   GPT_StartTimer, 0xffffffff if GPT_startTime is not called, 0 if an overflow occurred
  */
-unsigned long int GPT_GetRemainingTime(void){
+unsigned long int GPT_GetRemainingTime(uint8 Timer){
+	TimxType * timer;
+
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return 0xffffffff;
+	}
+	timer = GPT_GetRegisters(Timer);
+	/* check if an overflow is latched (the counter is already stopped by the one pulse mode)*/
+	if(gpt_instance[Timer].Expired == TRUE){
+		return 0;
+	}
 	/* check if timer not started*/
-	if(READ_BIT(TIM2->CR1,0) == 0){
+	else if(READ_BIT(timer->CR1,0) == 0){
 		return 0xffffffff;
 	}
-	else if(GPT_CheckTimeIsElapsed() == NO_OVERFLOW ){
-		unsigned long int remainig_ticks = TIM2->ARR - TIM2->CNT;
+	else if(GPT_CheckTimeIsElapsed(Timer) == NO_OVERFLOW ){
+		unsigned long int remainig_ticks = GPT_TicksToMs((timer->ARR + 1) - timer->CNT, TRUE);
 		return remainig_ticks;
 	}else{
 		/* Overflow */
@@ -166,24 +450,276 @@ unsigned long int GPT_GetRemainingTime(void){
 
 /*
  * Function : GPT_StopTimer
- * Input : void
+ * Input : uint8 Timer
  * Output : void
  * Description :
  *  A function to Stop the GPT timer without clearing the counter register to be able to cintinue counting be ContinueTimer
  */
-void GPT_StopTimer(void){
+void GPT_StopTimer(uint8 Timer){
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
 	/*stop the timer */
-	CLEAR_BIT(TIM2->CR1,0);
+	CLEAR_BIT(GPT_GetRegisters(Timer)->CR1,0);
 }
 
 /*
  * Function : GPT_ContinueTimer
- * Input : void
+ * Input : uint8 Timer
  * Output : void
  * Description :
  *  A function to Continue the GPT timer after stopping it.
  */
-void GPT_ContinueTimer(void){
+void GPT_ContinueTimer(uint8 Timer){
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
 	/*Enable counter by setting Counter Enable bit Control Register 1 */
-	SET_BIT(TIM2->CR1,0);
+	SET_BIT(GPT_GetRegisters(Timer)->CR1,0);
+}
+
+/*
+ * Function : GPT_Snapshot
+ * Input : uint8 Timer, GPT_SnapshotType * Snapshot
+ * Output : void
+ * Description :
+ *  A function to read CNT, CR1, SR and ARR registers one time (in this order) and return the status,
+ *  the elapsed and the remaining ticks of the same instant, without ending the timer or clearing the overflow.
+ *  The update flag is read after the counter : an expiry between the reads is seen in SR, so a set
+ *  UIF is reported as an overflow whatever CEN reads (a counter read before the expiry is not used).
+ *  OVERFLOW : elapsed is the overflow ticks and remaining is 0.
+ *  NO_OVERFLOW : the timer is counting.
+ *  TIMER_NOT_STARTED : the timer is stopped by GPT_StopTimer (elapsed and remaining are kept)
+ *  or it is not started (elapsed is 0 and remaining is 0xffffffff).
+ */
+void GPT_Snapshot(uint8 Timer, GPT_SnapshotType * Snapshot){
+	TimxType * timer;
+	GPT_InstanceType * instance;
+	uint32 cr1;
+	uint32 sr;
+	uint32 cnt;
+	uint32 arr;
+
+	if ((Timer >= GPT_NUM_OF_TIMERS) || (Snapshot == 0))
+	{
+		return;
+	}
+	timer = GPT_GetRegisters(Timer);
+	instance = &gpt_instance[Timer];
+
+	/* One read of each register, the counter before the update flag */
+	cnt = timer->CNT;
+	cr1 = timer->CR1;
+	sr = timer->SR;
+	arr = timer->ARR;
+
+	if ((instance->Expired == TRUE) || ((instance->OverflowFlag == NO_OVERFLOW) && (READ_BIT(sr,0) == 1)))
+	{
+		/* Overflow latched, or update flag set before the interrupt (held off or pending) */
+		Snapshot->Status = OVERFLOW;
+		Snapshot->Elapsed = GPT_TicksToMs(arr + 1, FALSE);
+		Snapshot->Remaining = 0;
+	}
+	else if (READ_BIT(cr1,0) == 1)
+	{
+		Snapshot->Status = NO_OVERFLOW;
+		Snapshot->Elapsed = GPT_TicksToMs(cnt, FALSE);
+		Snapshot->Remaining = GPT_TicksToMs((arr + 1) - cnt, TRUE);
+	}
+	else if (instance->OverflowFlag == NO_OVERFLOW)
+	{
+		/* Stopped by GPT_StopTimer, it can continue */
+		Snapshot->Status = TIMER_NOT_STARTED;
+		Snapshot->Elapsed = GPT_TicksToMs(cnt, FALSE);
+		Snapshot->Remaining = GPT_TicksToMs((arr + 1) - cnt, TRUE);
+	}
+	else
+	{
+		Snapshot->Status = TIMER_NOT_STARTED;
+		Snapshot->Elapsed = 0;
+		Snapshot->Remaining = 0xffffffff;
+	}
+}
+
+/*
+ * Function : GPT_SetCallback
+ * Input : uint8 Timer, GPT_CallbackType Callback
+ * Output : void
+ * Description :
+ *  A function to register the function called from the timer interrupt when the timer expires (0 to remove).
+ */
+void GPT_SetCallback(uint8 Timer, GPT_CallbackType Callback){
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
+	gpt_instance[Timer].Callback = Callback;
+}
+
+/*
+ * Function : GPT_SetProbe
+ * Input : uint8 Timer, uint8 Probe
+ * Output : void
+ * Description :
+ *  A function to measure the interrupt of the timer with the latency probe Probe (Latency_Start at its entry,
+ *  Latency_Stop at its exit, whatever driver owns the timer). GPT_NO_PROBE (the default) measures nothing.
+ */
+void GPT_SetProbe(uint8 Timer, uint8 Probe){
+	if (Timer >= GPT_NUM_OF_TIMERS)
+	{
+		return;
+	}
+	gpt_probe[Timer] = Probe;
+}
+
+
+/*
+ * Function : GPT_ClockInit
+ * Input : void
+ * Output : uint8 GPT_OK or GPT_NOK
+ * Description :
+ *  A function to start TIM5 as a free running counter of GPT_CLOCK_TICKS_PER_MS ticks per ms
+ *  and its update interrupt to extend the count to 64 bits.
+ *  It returns GPT_NOK if TIM5 is owned by another driver.
+ */
+uint8 GPT_ClockInit(void){
+
+	if (GPT_Claim(GPT_TIM5, GPT_ClockIrq) != GPT_OK)
+	{
+		return GPT_NOK;
+	}
+
+	/* Enable Clock for TIMER 5 and its interrupt on NVIC */
+	GPT_Enable(GPT_TIM5);
+
+	/* set Update request source (URS) to generate update flag from overflow only*/
+	SET_BIT(TIM5->CR1,2);
+	/* pre_scaler derived from the timers clock (84 MHz / 83+1 : 1 us) */
+	TIM5->PSC = GPT_GetPrescaler(GPT_CLOCK_TICKS_PER_MS * 1000UL);
+	/* count from 0 to 0xFFFFFFFF then wrap */
+	TIM5->ARR = 0xFFFFFFFF;
+	/* generate an update event (UG) to load the prescaler */
+	SET_BIT(TIM5->EGR,0);
+	/* Channel 1 is the alarm : output compare without output (CC1S = 00, OC1M = 000 : frozen) */
+	TIM5->CCMR1 &= ~(0xFFUL);
+	gpt_clock_high = 0;
+	gpt_alarm_forced = FALSE;
+
+	/* enable update interrupt (overflow of the low 32 bits) */
+	SET_BIT(TIM5->DIER,0);
+	/* Start the counter */
+	SET_BIT(TIM5->CR1,0);
+	return GPT_OK;
+}
+
+/*
+ * Function : GPT_GetTicks64
+ * Input : void
+ * Output : uint64
+ * Description :
+ *  A function to return the number of ticks since GPT_ClockInit, it never goes back.
+ *  It can be called from the thread and from any interrupt (also with the interrupts disabled).
+ */
+uint64 GPT_GetTicks64(void){
+	uint32 high;
+	uint32 low;
+	uint32 overflow;
+
+	/* Read again if the update interrupt counted an overflow between the reads */
+	do
+	{
+		high = gpt_clock_high;
+		low = TIM5->CNT;
+		overflow = READ_BIT(TIM5->SR,0);
+	} while (high != gpt_clock_high);
+
+	/* Overflow not counted yet by the update interrupt (pending or masked) :
+	 * a low value was read after the wrap, a high value before it */
+	if ((overflow != 0) && (low < 0x80000000UL))
+	{
+		high++;
+	}
+	return ((uint64)high << 32) | low;
+}
+
+/*
+ * Function : GPT_GetTimeMs64
+ * Input : void
+ * Output : uint64
+ * Description :
+ *  A function to return the number of ms since GPT_ClockInit.
+ */
+uint64 GPT_GetTimeMs64(void){
+	return GPT_GetTicks64() / GPT_CLOCK_TICKS_PER_MS;
+}
+
+/*
+ * Function : GPT_ClockSetAlarm
+ * Input : uint64 Ticks
+ * Output : void
+ * Description :
+ *  A function to request a call of the alarm callback when the clock reaches Ticks,
+ *  the callback is called at once (from the TIM5 interrupt) if Ticks is already reached.
+ *  It replaces the previous alarm.
+ */
+void GPT_ClockSetAlarm(uint64 Ticks){
+	/* compare on the low 32 bits, an early match (Ticks more than one wrap away) is filtered by the callback */
+	TIM5->CCR1 = (uint32)Ticks;
+	/* drop an old compare flag */
+	TIM5->SR = (uint32)~(1UL << 1);
+	/* enable compare 1 interrupt */
+	SET_BIT(TIM5->DIER,1);
+
+	/* The time is already reached : the match will not come, pend the interrupt */
+	if (Ticks <= GPT_GetTicks64())
+	{
+		gpt_alarm_forced = TRUE;
+		NVIC->ISPR[TIM5_IRQ_POSITION / 32] = (1UL << (TIM5_IRQ_POSITION % 32));
+	}
+}
+
+/*
+ * Function : GPT_ClockCancelAlarm
+ * Input : void
+ * Output : void
+ * Description :
+ *  A function to cancel the alarm, it also keeps the alarm callback from running till the next GPT_ClockSetAlarm.
+ */
+void GPT_ClockCancelAlarm(void){
+	/* disable compare 1 interrupt */
+	CLEAR_BIT(TIM5->DIER,1);
+	gpt_alarm_forced = FALSE;
+}
+
+/*
+ * Function : GPT_ClockSetAlarmCallback
+ * Input : GPT_CallbackType Callback
+ * Output : void
+ * Description :
+ *  A function to register the function called from the TIM5 interrupt at the alarm (0 to remove).
+ */
+void GPT_ClockSetAlarmCallback(GPT_CallbackType Callback){
+	gpt_alarm_callback = Callback;
+}
+
+/*******************************************************************************
+ *                      Interrupt Handlers                                     *
+ *******************************************************************************/
+
+void TIM2_IRQHandler(void) {
+	GPT_IrqDispatch(GPT_TIM2);
+}
+
+void TIM3_IRQHandler(void) {
+	GPT_IrqDispatch(GPT_TIM3);
+}
+
+void TIM4_IRQHandler(void) {
+	GPT_IrqDispatch(GPT_TIM4);
+}
+
+void TIM5_IRQHandler(void) {
+	GPT_IrqDispatch(GPT_TIM5);
 }
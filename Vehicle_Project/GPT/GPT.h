@@ -15,15 +15,36 @@
 #include "Std_Types.h"
 
 /* GPT Driver Documentation */
-/* General Purpose Timer 2 Driver Using Up Counting Mode 
- * 1. Initialize the GPT module by calling GPT_Init() function.
- * 2. Start the GPT by calling GPT_StartTimer( ms ) function and passing to it the time in ms.
- * 3. Check if the time is elapsed by calling GPT_CheckTimeIsElapsed() function.
- * 4. Get elapsed time in ms using GPT_GetElapsedTime() function.
- * 5. Get remaining time in ms using GPT_GetRemainingTime() function.
- * 6. End the current timer by calling GPT_EndTimer() function.
- * 7. Stop the current timer by calling GPT_StopTimer() function.
- * 8. Continue the current timer by calling GPT_ContinueTimer() function.
+/* General Purpose Timers (TIM2 .. TIM5) Driver Using Up Counting Mode
+ * Every function takes the timer instance (GPT_TIM2 .. GPT_TIM5), each timing domain owns its timer.
+ * 1. Initialize the timer by calling GPT_Init( timer ) function.
+ * 2. Start the GPT by calling GPT_StartTimer( timer, ms ) function and passing to it the time in ms.
+ * 3. Check if the time is elapsed by calling GPT_CheckTimeIsElapsed( timer ) function.
+ * 4. Get elapsed time in ms using GPT_GetElapsedTime( timer ) function.
+ * 5. Get remaining time in ms using GPT_GetRemainingTime( timer ) function.
+ * 6. End the current timer by calling GPT_EndTimer( timer ) function.
+ * 7. Stop the current timer by calling GPT_StopTimer( timer ) function.
+ * 8. Continue the current timer by calling GPT_ContinueTimer( timer ) function.
+ * 9. Register a function called at the expiry by calling GPT_SetCallback( timer, callback ) function.
+ * 10. Read the status, elapsed and remaining time together by calling GPT_Snapshot( timer, snapshot ),
+ *     it reads the registers once and has no side effect (steps 3, 4 and 5 in one call).
+ * The expiry is latched by the update interrupt of the timer, it is never missed by a late polling.
+ *
+ * Timers Ownership
+ * A timer belongs to one driver : GPT_Init, GPT_ClockInit (TIM5) and Pwm_Init take it with GPT_Claim()
+ * and fail if another driver owns it. The TIMx interrupt handlers are defined here and call the owner.
+ * The owner enables the timer with GPT_Enable(), reaches its registers with GPT_GetRegisters() (GPT_Private.h)
+ * and derives its prescaler with GPT_GetPrescaler().
+ * The time of the owner in each interrupt is measured by a latency probe given by GPT_SetProbe().
+ * The prescalers are derived from the RCC clocks (Rcc_GetClocks), configure the clock tree first.
+ *
+ * Monotonic Clock on Timer 5
+ * 1. Start the clock by calling GPT_ClockInit() function, TIM5 counts freely in us.
+ * 2. Read the time since GPT_ClockInit by calling GPT_GetTicks64() (us) or GPT_GetTimeMs64() (ms),
+ *    from the thread or from any interrupt, without any lock.
+ * 3. Get a call at a given time by calling GPT_ClockSetAlarmCallback() then GPT_ClockSetAlarm( ticks ),
+ *    the alarm uses the compare channel 1 of TIM5 (one alarm at a time).
+ * The 32-bit counter is extended to 64 bits by the TIM5 update interrupt.
  *  */
 
 
@@ -36,91 +57,267 @@
 
 #define TIMER_NOT_STARTED 20
 
-//#define PSC_VALUE 15999
-#define PSC_VALUE 999
+/* Countdown tick resolution in us, the prescaler is derived from the APB1 timers clock by GPT_Init
+ * (the prescaler is 16-bit : 1 ms ticks do not fit at 84 MHz), the API stays in ms */
+#define GPT_TICK_US            100
+#define GPT_TICKS_PER_MS       (1000 / GPT_TICK_US)
+
+/* TIM5 tick 1 us, the prescaler is derived from the APB1 timers clock by GPT_ClockInit */
+#define GPT_CLOCK_TICKS_PER_MS 1000
+
+/* Timers instances */
+#define GPT_TIM2  0
+#define GPT_TIM3  1
+#define GPT_TIM4  2
+#define GPT_TIM5  3
+#define GPT_NUM_OF_TIMERS 4
+
+/* GPT_SetProbe : no latency probe on the timer interrupt */
+#define GPT_NO_PROBE  0xFF
+
+/* GPT_Claim / GPT_Init status */
+#define GPT_OK   0
+#define GPT_NOK  1
+
+/* Timers IRQ positions */
+#define TIM2_IRQ_POSITION 28
+#define TIM3_IRQ_POSITION 29
+#define TIM4_IRQ_POSITION 30
+#define TIM5_IRQ_POSITION 50
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Expiry callback, called from the timer interrupt */
+typedef void (*GPT_CallbackType)(void);
+
+/* Interrupt handler of the owner of a timer, called with the timer instance */
+typedef void (*GPT_IrqHandlerType)(uint8 Timer);
+
+/* Coherent state of the timer at one instant */
+typedef struct {
+	unsigned char Status;         /* NO_OVERFLOW / OVERFLOW / TIMER_NOT_STARTED */
+	unsigned long int Elapsed;    /* elapsed ticks since GPT_StartTimer */
+	unsigned long int Remaining;  /* remaining ticks till the overflow */
+} GPT_SnapshotType;
 
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
 
 /*
- * Function : GPT_Init
- * Input : void
+ * Function : GPT_Claim
+ * Input : uint8 Timer, GPT_IrqHandlerType Handler
+ * Output : uint8 GPT_OK or GPT_NOK
+ * Description :
+ *  A function to take the ownership of a timer, its interrupt calls Handler with the timer instance.
+ *  It returns GPT_NOK if the timer is owned by another handler (claiming it again with the same handler is allowed).
+ */
+uint8 GPT_Claim(uint8 Timer, GPT_IrqHandlerType Handler);
+
+/*
+ * Function : GPT_Release
+ * Input : uint8 Timer
  * Output : void
  * Description :
- * A function to initialize the GPT registers with the needed initial values
+ *  A function to stop a timer and its interrupts and give it back.
+ */
+void GPT_Release(uint8 Timer);
+
+/*
+ * Function : GPT_GetPrescaler
+ * Input : uint32 TickFreq
+ * Output : uint32 value of the prescaler register
+ * Description :
+ *  A function to derive the prescaler of an APB1 timer for TickFreq ticks per second from the RCC clocks
+ *  (limited to the 16-bit prescaler).
+ */
+uint32 GPT_GetPrescaler(uint32 TickFreq);
+
+/*
+ * Function : GPT_Enable
+ * Input : uint8 Timer
+ * Output : void
+ * Description :
+ *  A function to enable the clock of a timer and its interrupt on NVIC, called by the driver that claimed it
+ *  before its configuration (the interrupt sources of the timer are enabled in DIER by the driver).
+ */
+void GPT_Enable(uint8 Timer);
+
+/*
+ * Function : GPT_Init
+ * Input : uint8 Timer
+ * Output : uint8 GPT_OK or GPT_NOK
+ * Description :
+ * A function to initialize the registers of the timer with the needed initial values
  * to support the needed timing actions.
+ * It returns GPT_NOK if the timer is owned by another driver (PWM, monotonic clock).
  */
-void GPT_Init(void);
+uint8 GPT_Init(uint8 Timer);
 
 /*
  * Function : GPT_StartTimer
- * Input : unsigned long int OverFlowTicks
+ * Input : uint8 Timer, unsigned long int OverFlowTicks
  * Output : void
  * Description :
  *  A function to request the GPT to start and send its number of
- *  tickets before timer overflow and stop.
+ *  tickets before timer overflow and stop (1 ticket = 1 ms, counted in GPT_TICK_US).
+ *  TIM3 and TIM4 are 16-bit : their overflow is limited to 6553 ms (longer requests are clamped).
+ *  0 ms expires at once (the callback is called from the timer interrupt).
  */
-void GPT_StartTimer(unsigned long int OverFlowTicks);
+void GPT_StartTimer(uint8 Timer, unsigned long int OverFlowTicks);
 
 /*
  * Function : GPT_EndTimer
- * Input : void
+ * Input : uint8 Timer
  * Output : void
  * Description :
  *  A function to End the GPT timer and clear the counter register to be able to start new timer
  */
-void GPT_EndTimer(void);
+void GPT_EndTimer(uint8 Timer);
 
 /*
  * Function : GPT_CheckTimeIsElapsed
- * Input : void
+ * Input : uint8 Timer
  * Output : unsigned char
  * Description :
  * A function to return (1) if an overflow occurred after the last call of GPT_StartTimer
  * and (0) if no overflow occurred or GPT_StartTimer is not called from the last read.
  */
-unsigned char GPT_CheckTimeIsElapsed(void);
+unsigned char GPT_CheckTimeIsElapsed(uint8 Timer);
 
 /*
  * Function : GPT_GetElapsedTime
- * Input : void
+ * Input : uint8 Timer
  * Output : unsigned long int
  * Description :
  *  A function to return number of elapsed ticks from the last call of the GPT_StartTimer,
  *  0 if it is not called and 0xffffffff if an overflow occurred.
  */
-unsigned long int GPT_GetElapsedTime(void);
+unsigned long int GPT_GetElapsedTime(uint8 Timer);
 
 /*
  * Function : GPT_GetRemainingTime
- * Input : void
+ * Input : uint8 Timer
  * Output : unsigned long int
  * Description :
  *   A function to return number of remaining ticks till the overflow ticks passed to
  *   GPT_StartTimer, 0xffffffff if GPT_startTime is not called, 0 if an overflow occurred
  */
-unsigned long int GPT_GetRemainingTime(void);
+unsigned long int GPT_GetRemainingTime(uint8 Timer);
 
 
 
 /*
  * Function : GPT_StopTimer
- * Input : void
+ * Input : uint8 Timer
  * Output : void
  * Description :
  *  A function to Stop the GPT timer without clearing the counter register to be able to cintinue counting be ContinueTimer
  */
-void GPT_StopTimer(void);
+void GPT_StopTimer(uint8 Timer);
 
 /*
  * Function : GPT_ContinueTimer
- * Input : void
+ * Input : uint8 Timer
  * Output : void
  * Description :
  *  A function to Continue the GPT timer after stopping it.
  */
-void GPT_ContinueTimer(void);
+void GPT_ContinueTimer(uint8 Timer);
+
+/*
+ * Function : GPT_Snapshot
+ * Input : uint8 Timer, GPT_SnapshotType * Snapshot
+ * Output : void
+ * Description :
+ *  A function to read CNT, CR1, SR and ARR registers one time (in this order) and return the status,
+ *  the elapsed and the remaining ticks of the same instant, without ending the timer or clearing the overflow.
+ *  OVERFLOW : the update flag is set (whatever CEN reads) or the expiry is latched, elapsed is the overflow ticks and remaining is 0.
+ *  NO_OVERFLOW : the timer is counting.
+ *  TIMER_NOT_STARTED : the timer is stopped by GPT_StopTimer (elapsed and remaining are kept)
+ *  or it is not started (elapsed is 0 and remaining is 0xffffffff).
+ */
+void GPT_Snapshot(uint8 Timer, GPT_SnapshotType * Snapshot);
+
+/*
+ * Function : GPT_SetCallback
+ * Input : uint8 Timer, GPT_CallbackType Callback
+ * Output : void
+ * Description :
+ *  A function to register the function called from the timer interrupt when the timer expires (0 to remove).
+ */
+void GPT_SetCallback(uint8 Timer, GPT_CallbackType Callback);
+
+/*
+ * Function : GPT_SetProbe
+ * Input : uint8 Timer, uint8 Probe
+ * Output : void
+ * Description :
+ *  A function to measure the interrupt of the timer with the latency probe Probe (Latency_Start at its entry,
+ *  Latency_Stop at its exit, whatever driver owns the timer). GPT_NO_PROBE (the default) measures nothing.
+ */
+void GPT_SetProbe(uint8 Timer, uint8 Probe);
+
+/*
+ * Function : GPT_ClockInit
+ * Input : void
+ * Output : uint8 GPT_OK or GPT_NOK
+ * Description :
+ *  A function to start TIM5 as a free running counter of GPT_CLOCK_TICKS_PER_MS ticks per ms
+ *  and its update interrupt to extend the count to 64 bits.
+ *  It returns GPT_NOK if TIM5 is owned by another driver.
+ */
+uint8 GPT_ClockInit(void);
+
+/*
+ * Function : GPT_GetTicks64
+ * Input : void
+ * Output : uint64
+ * Description :
+ *  A function to return the number of ticks since GPT_ClockInit, it never goes back.
+ *  It can be called from the thread and from any interrupt (also with the interrupts disabled).
+ */
+uint64 GPT_GetTicks64(void);
+
+/*
+ * Function : GPT_GetTimeMs64
+ * Input : void
+ * Output : uint64
+ * Description :
+ *  A function to return the number of ms since GPT_ClockInit.
+ */
+uint64 GPT_GetTimeMs64(void);
+
+/*
+ * Function : GPT_ClockSetAlarm
+ * Input : uint64 Ticks
+ * Output : void
+ * Description :
+ *  A function to request a call of the alarm callback when the clock reaches Ticks,
+ *  the callback is called at once (from the TIM5 interrupt) if Ticks is already reached.
+ *  It replaces the previous alarm.
+ */
+void GPT_ClockSetAlarm(uint64 Ticks);
+
+/*
+ * Function : GPT_ClockCancelAlarm
+ * Input : void
+ * Output : void
+ * Description :
+ *  A function to cancel the alarm, it also keeps the alarm callback from running till the next GPT_ClockSetAlarm.
+ */
+void GPT_ClockCancelAlarm(void);
+
+/*
+ * Function : GPT_ClockSetAlarmCallback
+ * Input : GPT_CallbackType Callback
+ * Output : void
+ * Description :
+ *  A function to register the function called from the TIM5 interrupt at the alarm (0 to remove).
+ */
+void GPT_ClockSetAlarmCallback(GPT_CallbackType Callback);
 
 
 #endif /* GPT_H_ */
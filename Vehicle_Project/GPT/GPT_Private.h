@@ -55,10 +55,22 @@ typedef struct {
 }TimxType;
 
 /* Pointers to base address with structures data type */
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Simulated timers registers of the host backend */
+#define TIM2 ((TimxType *)Host_Access(HOST_TIM2))
+#define TIM3 ((TimxType *)Host_Access(HOST_TIM3))
+#define TIM4 ((TimxType *)Host_Access(HOST_TIM4))
+#define TIM5 ((TimxType *)Host_Access(HOST_TIM5))
+#else
 #define TIM2 ((TimxType *)TIM2_BASE_ADDR)
 #define TIM3 ((TimxType *)TIM3_BASE_ADDR)
 #define TIM4 ((TimxType *)TIM4_BASE_ADDR)
 #define TIM5 ((TimxType *)TIM5_BASE_ADDR)
+#endif
+
+/* Registers of a timer (GPT_TIM2 .. GPT_TIM5) for the driver that owns it */
+TimxType * GPT_GetRegisters(uint8 Timer);
 
 
 
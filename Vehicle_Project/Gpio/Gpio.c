@@ -23,6 +23,11 @@
 
 #define GPIO_REG(REG_ID, PORT_ID)  ((uint32 *)((REG_ID) + (PORT_ID)))
 
+/* Insert a field in a register image, computed in uint32 : the fields of pin 15 (2 bits)
+ * and of pins 7 / 15 in AFRL / AFRH (4 bits) reach bit 31 */
+#define GPIO_INSERT_FIELD(REG, SHIFT, MASK, VALUE) \
+	((REG) = ((REG) & ~((uint32)(MASK) << (SHIFT))) | (((uint32)(VALUE) & (uint32)(MASK)) << (SHIFT)))
+
 uint32 gpioAddresses[6] = {GPIOA_BASE_ADDR,GPIOB_BASE_ADDR,GPIOC_BASE_ADDR,GPIOD_BASE_ADDR,GPIOE_BASE_ADDR,GPIOH_BASE_ADDR};
 
 /*******************************************************************************
@@ -87,7 +92,7 @@ void Gpio_ConfigPin(uint8 PortName, uint8 PinNum, uint8 PinMode, uint8 DefaultSt
 	else
 	{
 		uint8 portId = PortName - GPIO_A;
-		GpioType * gpioRegs = (GpioType *) gpioAddresses[portId];
+		GpioType * gpioRegs = GPIO_PORT_REGS(portId);
 
 		/* Insert PinMode in PinNum Block in Moder Register*/
 		INSERT_2BITS_BLOCK( gpioRegs->GPIO_MODER , PinNum, PinMode);
@@ -104,7 +109,7 @@ void Gpio_ConfigPin(uint8 PortName, uint8 PinNum, uint8 PinMode, uint8 DefaultSt
 uint8 Gpio_WritePinValue(uint8 PortName, uint8 PinNum, uint8 Data) {
 
 	uint8 portId = PortName - GPIO_A;
-	GpioType * gpioRegs = (GpioType *) gpioAddresses[portId];
+	GpioType * gpioRegs = GPIO_PORT_REGS(portId);
 
 	/*check if the pin is output*/
 	if ( GPIO_OUTPUT == (READ_2BITS_BLOCK( gpioRegs->GPIO_MODER ,PinNum)) )
@@ -122,7 +127,7 @@ uint8 Gpio_WritePinValue(uint8 PortName, uint8 PinNum, uint8 Data) {
 uint8 Gpio_ReadPinState(uint8 PortName, uint8 PinNum){
 
 	uint8 portId = PortName - GPIO_A;
-	GpioType * gpioRegs = (GpioType *) gpioAddresses[portId];
+	GpioType * gpioRegs = GPIO_PORT_REGS(portId);
 
 	/*check if the pin is input*/
 	if ( GPIO_INPUT == (READ_2BITS_BLOCK(gpioRegs->GPIO_MODER ,PinNum)) )
@@ -137,3 +142,127 @@ uint8 Gpio_ReadPinState(uint8 PortName, uint8 PinNum){
 	}
 
 }
+
+void Gpio_WritePortMasked(uint8 PortName, uint16 SetMask, uint16 ClearMask) {
+
+	/* Check if the input port Name is not valid */
+	if(PortName >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		uint8 portId = PortName - GPIO_A;
+		GpioType * gpioRegs = GPIO_PORT_REGS(portId);
+
+		/* Reset bits in the high half word and Set bits in the low half word of BSRR Register */
+		gpioRegs->GPIO_BSRR = ((uint32)ClearMask << 16) | SetMask;
+	}
+}
+
+void Gpio_ConfigPort(uint8 PortName, const Gpio_PinConfigType * ConfigTable, uint8 NumOfPins) {
+
+	/* Check if the input port Name is not valid */
+	if((PortName >= NUM_OF_PORTS) || (ConfigTable == 0))
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		uint8 portId = PortName - GPIO_A;
+		GpioType * gpioRegs = GPIO_PORT_REGS(portId);
+
+		/* Bits to be changed and their new values for each register */
+		uint32 modeMask = 0, modeValue = 0;
+		uint32 typeMask = 0, typeValue = 0;
+		uint32 speedMask = 0, speedValue = 0;
+		uint32 pullMask = 0, pullValue = 0;
+		uint32 afLowMask = 0, afLowValue = 0;
+		uint32 afHighMask = 0, afHighValue = 0;
+		uint8 index;
+
+		/* 1- Build the registers images from the table */
+		for (index = 0; index < NumOfPins; index++)
+		{
+			const Gpio_PinConfigType * pinConfig = &ConfigTable[index];
+			uint8 PinNum = pinConfig->PinNum;
+
+			if (PinNum >= NUM_OF_PINS_PER_PORT)
+			{
+				/* Skip wrong pin number */
+				continue;
+			}
+			GPIO_INSERT_FIELD(modeMask, PinNum * 2U, 0x03UL, 0x03UL);
+			GPIO_INSERT_FIELD(modeValue, PinNum * 2U, 0x03UL, pinConfig->PinMode);
+			SET_BIT(typeMask, PinNum);
+			INSERT_BIT(typeValue, PinNum, pinConfig->DefaultState);
+			GPIO_INSERT_FIELD(speedMask, PinNum * 2U, 0x03UL, 0x03UL);
+			GPIO_INSERT_FIELD(speedValue, PinNum * 2U, 0x03UL, pinConfig->OutputSpeed);
+			GPIO_INSERT_FIELD(pullMask, PinNum * 2U, 0x03UL, 0x03UL);
+			GPIO_INSERT_FIELD(pullValue, PinNum * 2U, 0x03UL, pinConfig->InputMode);
+			if (PinNum < 8)
+			{
+				GPIO_INSERT_FIELD(afLowMask, PinNum * 4U, 0x0FUL, 0x0FUL);
+				GPIO_INSERT_FIELD(afLowValue, PinNum * 4U, 0x0FUL, pinConfig->AlternateFunction);
+			}
+			else
+			{
+				GPIO_INSERT_FIELD(afHighMask, (PinNum - 8U) * 4U, 0x0FUL, 0x0FUL);
+				GPIO_INSERT_FIELD(afHighValue, (PinNum - 8U) * 4U, 0x0FUL, pinConfig->AlternateFunction);
+			}
+		}
+
+		/* 2- Write each register once, alternate functions and speed before the mode */
+		if (afLowMask != 0)
+		{
+			gpioRegs->GPIO_AFRL = (gpioRegs->GPIO_AFRL & ~afLowMask) | afLowValue;
+		}
+		if (afHighMask != 0)
+		{
+			gpioRegs->GPIO_AFRH = (gpioRegs->GPIO_AFRH & ~afHighMask) | afHighValue;
+		}
+		if (modeMask != 0)
+		{
+			gpioRegs->GPIO_OTYPER = (gpioRegs->GPIO_OTYPER & ~typeMask) | typeValue;
+			gpioRegs->GPIO_OSPEEDR = (gpioRegs->GPIO_OSPEEDR & ~speedMask) | speedValue;
+			gpioRegs->GPIO_PUPDR = (gpioRegs->GPIO_PUPDR & ~pullMask) | pullValue;
+			gpioRegs->GPIO_MODER = (gpioRegs->GPIO_MODER & ~modeMask) | modeValue;
+		}
+	}
+}
+
+uint8 Gpio_ReadPortSnapshot(uint8 PortName, uint16 Mask, uint16 * Snapshot) {
+
+	/* Check if the input port Name or the output pointer are not valid */
+	if((PortName >= NUM_OF_PORTS) || (Snapshot == 0))
+	{
+		return NOK;
+	}
+	else
+	{
+		uint8 portId = PortName - GPIO_A;
+		GpioType * gpioRegs = GPIO_PORT_REGS(portId);
+		uint32 moder = gpioRegs->GPIO_MODER;
+		uint16 inputPins = 0;
+		uint8 PinNum;
+
+		/* 1- Get the input pins of the port from MODER Register (mode 00) */
+		for (PinNum = 0; PinNum < NUM_OF_PINS_PER_PORT; PinNum++)
+		{
+			if (GPIO_INPUT == READ_2BITS_BLOCK(moder, PinNum))
+			{
+				inputPins |= GPIO_MASK(PinNum);
+			}
+		}
+
+		/* Check that all the requested pins are inputs */
+		if ((Mask & inputPins) != Mask)
+		{
+			return NOK;
+		}
+
+		/* 2- Sample all the requested pins with one read of IDR Register */
+		*Snapshot = (uint16)(gpioRegs->GPIO_IDR & Mask);
+		return OK;
+	}
+}
@@ -54,14 +54,55 @@
 #define GPIO_PULL_DOWN 0x02
 #define RESERVED 0x11
 
+/*OutputSpeed*/
+#define GPIO_SPEED_LOW    0x00
+#define GPIO_SPEED_MEDIUM 0x01
+#define GPIO_SPEED_FAST   0x02
+#define GPIO_SPEED_HIGH   0x03
+
+/*AlternateFunction*/
+#define GPIO_AF0   0x00
+#define GPIO_AF1   0x01
+#define GPIO_AF2   0x02
+#define GPIO_AF3   0x03
+#define GPIO_AF4   0x04
+#define GPIO_AF5   0x05
+#define GPIO_AF6   0x06
+#define GPIO_AF7   0x07
+#define GPIO_AF8   0x08
+#define GPIO_AF9   0x09
+#define GPIO_AF10  0x0A
+#define GPIO_AF11  0x0B
+#define GPIO_AF12  0x0C
+#define GPIO_AF13  0x0D
+#define GPIO_AF14  0x0E
+#define GPIO_AF15  0x0F
+
 /*Data*/
 #define LOW  0x00
 #define HIGH 0x01
 
+/*Pin Mask (used by the port functions)*/
+#define GPIO_MASK(PinNum) ((uint16)(1u << (PinNum)))
+
 /*Return Status*/
 #define OK  50
 #define NOK 60
 
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Configuration of one pin inside a Gpio_ConfigPort table */
+typedef struct {
+	uint8 PinNum;            /* 0 .. 15 */
+	uint8 PinMode;           /* GPIO_INPUT / GPIO_OUTPUT / GPIO_AF / GPIO_ANALOG */
+	uint8 DefaultState;      /* GPIO_PUSH_PULL / GPIO_OPEN_DRAIN */
+	uint8 InputMode;         /* GPIO_NO_PULL / GPIO_PULL_UP / GPIO_PULL_DOWN */
+	uint8 OutputSpeed;       /* GPIO_SPEED_LOW .. GPIO_SPEED_HIGH */
+	uint8 AlternateFunction; /* GPIO_AF0 .. GPIO_AF15 */
+} Gpio_PinConfigType;
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -74,7 +115,7 @@
     * Initialize GPIO Driver
     * Enable Clock for used GPIO PORTs using Static Configurationin RCC Register .
     */
-void GPIO_Init(void);
+void Gpio_Init(void);
 
 /*
  * Function : Gpio_ConfigPin
@@ -111,5 +152,49 @@ uint8 Gpio_WritePinValue(uint8 PortName, uint8 PinNum, uint8 Data);
  */
 uint8 Gpio_ReadPinState(uint8 PortName, uint8 PinNum);
 
+/*
+ * Function : Gpio_WritePortMasked
+ * Input : PortName, SetMask, ClearMask
+ * Output : void
+ * Description :
+ * Write Port
+ * 1- Set the pins of SetMask and clear the pins of ClearMask with one store to BSRR Register .
+ * The store is atomic, so an interrupt can never observe or corrupt a half written port.
+ * If a pin is in both masks it is set (BSRR gives priority to the set bits).
+ * The pin direction is not checked, the caller must only pass pins configured as output.
+ *  If the input port number is not correct, The function will not handle the request.
+ */
+void Gpio_WritePortMasked(uint8 PortName, uint16 SetMask, uint16 ClearMask);
+
+/*
+ * Function : Gpio_ConfigPort
+ * Input : PortName, ConfigTable, NumOfPins
+ * Output : void
+ * Description :
+ * Configure Port
+ * 1- Build the final images of MODER, OTYPER, OSPEEDR, PUPDR, AFRL and AFRH Registers
+ *    from all the entries of the constant configuration table.
+ * 2- Write each register of the port one time only.
+ * Pins of the port that are not in the table keep their configuration.
+ * The pull up / pull down of the table is applied for all pin modes.
+ *  If the input port number is not correct, The function will not handle the request
+ *  and table entries with a wrong pin number are skipped.
+ */
+void Gpio_ConfigPort(uint8 PortName, const Gpio_PinConfigType * ConfigTable, uint8 NumOfPins);
+
+/*
+ * Function : Gpio_ReadPortSnapshot
+ * Input : PortName, Mask, Snapshot
+ * Output : uint8 OK or NOK
+ * Description :
+ * Read Port
+ * 1- Read IDR Register one time and store the pins of Mask in *Snapshot (other bits are 0).
+ * All the pins of the snapshot are sampled at the same instant.
+ * The pin levels and the status are separated, so the level of a pin is never confused with NOK.
+ *  If the input port number is not correct, Snapshot is a null pointer or a pin of Mask is not
+ *  configured as input, the function returns NOK and Snapshot is not written.
+ */
+uint8 Gpio_ReadPortSnapshot(uint8 PortName, uint16 Mask, uint16 * Snapshot);
+
 
 #endif /* GPIO_H_ */
@@ -0,0 +1,105 @@
+/* *****************************************************************************
+ * Module: GPIO
+ *
+ * File Name: Gpio_Pin.h
+ *
+ * Description: Compile-time resolved pin handles for the STM32 GPIO driver
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef GPIO_PIN_H_
+#define GPIO_PIN_H_
+
+#include "Std_Types.h"
+#include "Macros.h"
+#include "Gpio.h"
+#include "Gpio_Private.h"
+
+/* GPIO Pin Handles Documentation */
+/* A pin handle is an integer constant holding the port, the pin and the mode of a pin.
+ * 1. Define the handle once : #define LED_PIN GPIO_PIN_HANDLE(GPIO_B, 5, GPIO_OUTPUT)
+ * 2. Configure the pin by calling GPIO_PIN_CONFIG(LED_PIN, GPIO_PUSH_PULL, GPIO_NO_PULL).
+ * 3. Write the pin by calling GPIO_PIN_WRITE(LED_PIN, HIGH) : one store to BSRR Register.
+ * 4. Read the pin by calling GPIO_PIN_READ(BUTTON_PIN) : one load from IDR Register.
+ * The port base address is folded by the compiler and there is no MODER check at runtime,
+ * a handle with a wrong port, pin or mode for the requested action fails the build.
+ *  */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Handle Encoding : Mode in bits 16-23, Port in bits 8-15, Pin in bits 0-7 */
+#define GPIO_PIN_HANDLE(PortName, PinNum, PinMode)  (((uint32)(PinMode) << 16) | ((uint32)(PortName) << 8) | (uint32)(PinNum))
+
+#define GPIO_HANDLE_PIN(HANDLE)   ((uint8)((HANDLE) & 0xFF))
+#define GPIO_HANDLE_PORT(HANDLE)  ((uint8)(((HANDLE) >> 8) & 0xFF))
+#define GPIO_HANDLE_MODE(HANDLE)  ((uint8)(((HANDLE) >> 16) & 0xFF))
+#define GPIO_HANDLE_MASK(HANDLE)  GPIO_MASK(GPIO_HANDLE_PIN(HANDLE))
+
+/* Port registers of the handle (GPIOH is not contiguous with GPIOA..GPIOE) */
+#define GPIO_PORT_STRIDE          0x400
+#ifdef HOST_BACKEND
+#define GPIO_HANDLE_REGS(HANDLE)  GPIO_PORT_REGS(GPIO_HANDLE_PORT(HANDLE))
+#else
+#define GPIO_HANDLE_REGS(HANDLE)  ((GpioType *)((GPIO_HANDLE_PORT(HANDLE) == GPIO_H) ? GPIOH_BASE_ADDR : \
+                                   (GPIOA_BASE_ADDR + (GPIO_HANDLE_PORT(HANDLE) * GPIO_PORT_STRIDE))))
+#endif
+
+/* Build time check usable inside expressions */
+#define GPIO_STATIC_CHECK(COND, MSG)  ((void)sizeof(struct { _Static_assert(COND, MSG); char Dummy; }))
+
+/* Check that the handle is a valid pin of the required mode */
+#define GPIO_HANDLE_CHECK(HANDLE, PinMode) \
+	(GPIO_STATIC_CHECK(GPIO_HANDLE_PORT(HANDLE) < NUM_OF_PORTS, "GPIO pin handle : invalid port"), \
+	 GPIO_STATIC_CHECK(GPIO_HANDLE_PIN(HANDLE) < NUM_OF_PINS_PER_PORT, "GPIO pin handle : invalid pin"), \
+	 GPIO_STATIC_CHECK(GPIO_HANDLE_MODE(HANDLE) == (PinMode), "GPIO pin handle : wrong pin mode"))
+
+/*******************************************************************************
+ *                              Pin Handle Actions                             *
+ *******************************************************************************/
+
+/*
+ * Macro : GPIO_PIN_CONFIG
+ * Input : HANDLE, DefaultState, InputMode
+ * Description :
+ * Configure the pin of the handle with the mode stored in the handle by calling Gpio_ConfigPin.
+ */
+#define GPIO_PIN_CONFIG(HANDLE, DefaultState, InputMode) \
+	(GPIO_STATIC_CHECK(GPIO_HANDLE_PORT(HANDLE) < NUM_OF_PORTS, "GPIO pin handle : invalid port"), \
+	 GPIO_STATIC_CHECK(GPIO_HANDLE_PIN(HANDLE) < NUM_OF_PINS_PER_PORT, "GPIO pin handle : invalid pin"), \
+	 Gpio_ConfigPin(GPIO_HANDLE_PORT(HANDLE), GPIO_HANDLE_PIN(HANDLE), GPIO_HANDLE_MODE(HANDLE), (DefaultState), (InputMode)))
+
+/*
+ * Macro : GPIO_PIN_CONFIG_ENTRY
+ * Input : HANDLE, DefaultState, InputMode, OutputSpeed, AlternateFunction
+ * Description :
+ * Initializer of a Gpio_PinConfigType table entry using the pin and the mode stored in the handle.
+ */
+#define GPIO_PIN_CONFIG_ENTRY(HANDLE, DefaultState, InputMode, OutputSpeed, AlternateFunction) \
+	{ GPIO_HANDLE_PIN(HANDLE), GPIO_HANDLE_MODE(HANDLE), (DefaultState), (InputMode), (OutputSpeed), (AlternateFunction) }
+
+/*
+ * Macro : GPIO_PIN_WRITE
+ * Input : HANDLE, Data
+ * Description :
+ * Write Data to an output pin handle with one store to BSRR Register .
+ */
+#define GPIO_PIN_WRITE(HANDLE, Data) \
+	(GPIO_HANDLE_CHECK(HANDLE, GPIO_OUTPUT), \
+	 (void)(GPIO_HANDLE_REGS(HANDLE)->GPIO_BSRR = (Data) ? (uint32)GPIO_HANDLE_MASK(HANDLE) : ((uint32)GPIO_HANDLE_MASK(HANDLE) << 16)))
+
+/*
+ * Macro : GPIO_PIN_READ
+ * Input : HANDLE
+ * Output : 0 or 1
+ * Description :
+ * Read the state of an input pin handle from IDR Register .
+ */
+#define GPIO_PIN_READ(HANDLE) \
+	(GPIO_HANDLE_CHECK(HANDLE, GPIO_INPUT), \
+	 (uint8)READ_BIT(GPIO_HANDLE_REGS(HANDLE)->GPIO_IDR, GPIO_HANDLE_PIN(HANDLE)))
+
+#endif /* GPIO_PIN_H_ */
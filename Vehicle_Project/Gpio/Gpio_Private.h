@@ -35,4 +35,14 @@ typedef struct {
 	uint32 GPIO_AFRH;	  //alternate function high register
 } GpioType;
 
+/******************* GPIO Ports Registers ********************/
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Simulated ports registers of the host backend */
+#define GPIO_PORT_REGS(PORT_ID)  ((GpioType *)Host_Access(HOST_GPIOA + (PORT_ID)))
+#else
+extern uint32 gpioAddresses[];
+#define GPIO_PORT_REGS(PORT_ID)  ((GpioType *)gpioAddresses[PORT_ID])
+#endif
+
 #endif /* GPIO_PRIVATE_H */
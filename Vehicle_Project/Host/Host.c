@@ -0,0 +1,1320 @@
+/* *****************************************************************************
+ * Module: Host
+ *
+ * File Name: Host.c
+ *
+ * Description: Source file for the host register backend (simulated peripherals on Linux)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifdef HOST_BACKEND
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Host.h"
+#include "Std_Types.h"
+#include "Macros.h"
+#include "Gpio.h"
+#include "Gpio_Private.h"
+#include "GPT_Private.h"
+#include "NVIC_Private.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HOST_NUM_OF_TIMERS   4
+#define HOST_NUM_OF_LINES    16
+
+/* RCC registers (word index) and bits */
+#define HOST_RCC_SIZE        (0x88 / 4)
+#define HOST_RCC_CR          (0x00 / 4)
+#define HOST_RCC_PLLCFGR     (0x04 / 4)
+#define HOST_RCC_CFGR        (0x08 / 4)
+#define HOST_RCC_APB1ENR     (0x40 / 4)
+#define HOST_RCC_BDCR        (0x70 / 4)
+#define HOST_RCC_CSR         (0x74 / 4)
+#define HOST_RCC_LSION       0
+#define HOST_RCC_RTCSEL      8
+#define HOST_RCC_RTCEN       15
+#define HOST_RCC_RTCSEL_LSI  2
+#define HOST_RCC_HSION       0
+#define HOST_RCC_HSEON       16
+#define HOST_RCC_PLLON       24
+
+/* PWR and SCB registers (word index) and bits */
+#define HOST_PWR_SIZE        (0x08 / 4)
+#define HOST_PWR_CR          (0x00 / 4)
+#define HOST_PWR_PDDS        1
+#define HOST_SCB_SIZE        (0x100 / 4)
+#define HOST_SCB_AIRCR       (0x0C / 4)
+#define HOST_SCB_SCR         (0x10 / 4)
+#define HOST_SCB_SLEEPDEEP   2
+#define HOST_SCB_DEMCR       (0xFC / 4)
+#define HOST_DEMCR_TRCENA    24
+#define HOST_AIRCR_VECTKEY   0x05FAUL
+#define HOST_AIRCR_VECTKEYSTAT 0xFA05UL
+#define HOST_AIRCR_PRIGROUP  8
+#define HOST_FLASH_SIZE      (0x18 / 4)
+
+/* RTC registers (word index) : time of day counted from the enable of the RTC on LSI */
+#define HOST_RTC_SIZE        (0x50 / 4)
+#define HOST_RTC_TR          (0x00 / 4)
+#define HOST_RTC_PRER        (0x10 / 4)
+#define HOST_RTC_SSR         (0x28 / 4)
+#define HOST_RTC_PRER_RESET  0x007F00FFUL
+#define HOST_SECONDS_PER_DAY 86400ULL
+
+/* DWT registers (word index) and bits */
+#define HOST_DWT_SIZE        (0x08 / 4)
+#define HOST_DWT_CTRL        (0x00 / 4)
+#define HOST_DWT_CYCCNT      (0x04 / 4)
+#define HOST_DWT_CYCCNTENA   0
+
+/* TIMx registers bits */
+#define HOST_TIM_CEN         0
+#define HOST_TIM_UDIS        1
+#define HOST_TIM_URS         2
+#define HOST_TIM_OPM         3
+#define HOST_TIM_ARPE        7
+#define HOST_TIM_UIF         0
+#define HOST_TIM_UIE         0
+#define HOST_TIM_UG          0
+#define HOST_TIM_IRQ_FLAGS   0x5F
+
+/* Output compare modes (OCxM) */
+#define HOST_OC_ACTIVE          1
+#define HOST_OC_INACTIVE        2
+#define HOST_OC_TOGGLE          3
+#define HOST_OC_FORCE_INACTIVE  4
+#define HOST_OC_FORCE_ACTIVE    5
+
+/* Execution priority of the thread mode (lower than any interrupt) */
+#define HOST_THREAD_PRIORITY 0x100
+#define HOST_MAX_NESTING     16
+
+/* Virtual time between two calls of the access hook while the core sleeps */
+#define HOST_IDLE_STEP_NS    1000000ULL
+
+/* NVIC_STIR value while no software trigger is written */
+#define HOST_STIR_IDLE       0xFFFFFFFF
+
+#define HOST_NEVER           0xFFFFFFFFFFFFFFFFULL
+
+/*******************************************************************************
+ *                      Interrupt Vector Table                                 *
+ *******************************************************************************/
+
+void Host_DefaultHandler(void);
+
+/* Handlers not defined by the application fall back on the default handler */
+#define HOST_WEAK_HANDLER(NAME) void NAME(void) __attribute__((weak, alias("Host_DefaultHandler")))
+
+HOST_WEAK_HANDLER(EXTI0_IRQHandler);
+HOST_WEAK_HANDLER(EXTI1_IRQHandler);
+HOST_WEAK_HANDLER(EXTI2_IRQHandler);
+HOST_WEAK_HANDLER(EXTI3_IRQHandler);
+HOST_WEAK_HANDLER(EXTI4_IRQHandler);
+HOST_WEAK_HANDLER(EXTI9_5_IRQHandler);
+HOST_WEAK_HANDLER(TIM2_IRQHandler);
+HOST_WEAK_HANDLER(TIM3_IRQHandler);
+HOST_WEAK_HANDLER(TIM4_IRQHandler);
+HOST_WEAK_HANDLER(EXTI15_10_IRQHandler);
+HOST_WEAK_HANDLER(TIM5_IRQHandler);
+
+static void (* const host_vectors[HOST_NUM_OF_IRQS])(void) = {
+	[6]  = EXTI0_IRQHandler,
+	[7]  = EXTI1_IRQHandler,
+	[8]  = EXTI2_IRQHandler,
+	[9]  = EXTI3_IRQHandler,
+	[10] = EXTI4_IRQHandler,
+	[23] = EXTI9_5_IRQHandler,
+	[28] = TIM2_IRQHandler,
+	[29] = TIM3_IRQHandler,
+	[30] = TIM4_IRQHandler,
+	[40] = EXTI15_10_IRQHandler,
+	[50] = TIM5_IRQHandler,
+};
+
+/* Interrupt of each timer and of each EXTI line */
+static const uint8 host_timer_irq[HOST_NUM_OF_TIMERS] = { 28, 29, 30, 50 };
+static const uint8 host_line_irq[HOST_NUM_OF_LINES] = { 6, 7, 8, 9, 10, 23, 23, 23, 23, 23, 40, 40, 40, 40, 40, 40 };
+
+/* Timer channels on the alternate functions of the pins */
+typedef struct {
+	uint8 Port;
+	uint8 Pin;
+	uint8 Af;
+	uint8 Timer;      /* 0 : TIM2 .. 3 : TIM5 */
+	uint8 Channel;
+} host_AfChannelType;
+
+static const host_AfChannelType host_af_channels[] = {
+	{ GPIO_A, 0, 1, 0, 1 }, { GPIO_A, 1, 1, 0, 2 }, { GPIO_A, 2, 1, 0, 3 }, { GPIO_A, 3, 1, 0, 4 },
+	{ GPIO_A, 5, 1, 0, 1 }, { GPIO_A, 15, 1, 0, 1 }, { GPIO_B, 3, 1, 0, 2 }, { GPIO_B, 10, 1, 0, 3 },
+	{ GPIO_A, 6, 2, 1, 1 }, { GPIO_A, 7, 2, 1, 2 }, { GPIO_B, 0, 2, 1, 3 }, { GPIO_B, 1, 2, 1, 4 },
+	{ GPIO_B, 4, 2, 1, 1 }, { GPIO_B, 5, 2, 1, 2 }, { GPIO_C, 6, 2, 1, 1 }, { GPIO_C, 7, 2, 1, 2 },
+	{ GPIO_C, 8, 2, 1, 3 }, { GPIO_C, 9, 2, 1, 4 },
+	{ GPIO_B, 6, 2, 2, 1 }, { GPIO_B, 7, 2, 2, 2 }, { GPIO_B, 8, 2, 2, 3 }, { GPIO_B, 9, 2, 2, 4 },
+	{ GPIO_D, 12, 2, 2, 1 }, { GPIO_D, 13, 2, 2, 2 }, { GPIO_D, 14, 2, 2, 3 }, { GPIO_D, 15, 2, 2, 4 },
+	{ GPIO_A, 0, 2, 3, 1 }, { GPIO_A, 1, 2, 3, 2 }, { GPIO_A, 2, 2, 3, 3 }, { GPIO_A, 3, 2, 3, 4 },
+};
+
+/*******************************************************************************
+ *                      Simulated Registers                                    *
+ *******************************************************************************/
+
+static GpioType host_gpio[NUM_OF_PORTS];
+static TimxType host_tim[HOST_NUM_OF_TIMERS];
+static uint32 host_rcc[HOST_RCC_SIZE];
+static ExtiType host_exti;
+static SyscfgType host_syscfg;
+static NvicType host_nvic;
+static uint32 host_stir;
+static uint32 host_pwr[HOST_PWR_SIZE];
+static uint32 host_scb[HOST_SCB_SIZE];
+static uint32 host_flash[HOST_FLASH_SIZE];
+static uint32 host_dwt[HOST_DWT_SIZE];
+static uint32 host_rtc[HOST_RTC_SIZE];
+
+static void * const host_blocks[HOST_NUM_OF_BLOCKS] = {
+	&host_gpio[0], &host_gpio[1], &host_gpio[2], &host_gpio[3], &host_gpio[4], &host_gpio[5],
+	&host_tim[0], &host_tim[1], &host_tim[2], &host_tim[3],
+	host_rcc, &host_exti, &host_syscfg, &host_nvic, &host_stir, host_pwr, host_scb, host_flash,
+	host_dwt, host_rtc,
+};
+
+/*******************************************************************************
+ *                      Hidden Hardware State                                  *
+ *******************************************************************************/
+
+/* Timer state not visible in the registers */
+typedef struct {
+	uint32 PscShadow;  /* prescaler in use (PSC is loaded at update events) */
+	uint32 ArrShadow;  /* auto reload in use when ARPE is set */
+	uint32 CcrShadow[4]; /* compare values in use when OCxPE is set */
+	uint32 SrPresented; /* value left in TIMx_SR at the last access */
+	uint8 OcRef;       /* output compare reference level of each channel (bit 0 : channel 1) */
+	uint64 Acc;        /* clock units accumulated toward the next counter tick */
+} host_TimerStateType;
+
+static host_TimerStateType host_tim_state[HOST_NUM_OF_TIMERS];
+
+/* Pins */
+static uint16 host_driven[NUM_OF_PORTS];     /* pins driven by Host_SetPinInput */
+static uint16 host_input[NUM_OF_PORTS];      /* levels of the driven pins */
+static uint16 host_last_output[NUM_OF_PORTS];  /* pins levels given to the output hook */
+
+/* EXTI */
+static uint32 host_line_level;               /* level of the 16 lines at the last sampling */
+static uint32 host_pr;                       /* real pending lines */
+static uint32 host_pr_presented;             /* value left in EXTI_PR at the last access */
+static uint32 host_swier;
+
+/* NVIC */
+static uint32 host_enabled[8];
+static uint32 host_pending[8];
+static uint32 host_active[8];
+static uint16 host_active_prio[HOST_MAX_NESTING];
+static uint8  host_active_irq[HOST_MAX_NESTING];
+static uint32 host_active_lines[HOST_MAX_NESTING];
+static uint8  host_nesting;
+static uint32 host_entries;                  /* exception entries since the reset */
+
+/* Core */
+static boolean host_primask;
+static uint8 host_basepri;
+static uint8 host_prigroup;                  /* AIRCR PRIGROUP : group priority bits [7 : PRIGROUP + 1] */
+static boolean host_stopped;                 /* Stop mode : the clocks of the timers are stopped */
+static boolean host_sleeping;                /* WFI : the core clock is stopped */
+
+/* Clocks and time */
+static uint32 host_hclk;
+static uint32 host_apb1_div;
+static boolean host_pll_locks;               /* FALSE : PLLRDY stays low (PLL out of lock) */
+static boolean host_rtc_running;
+static uint64 host_rtc_origin_ns;            /* virtual time of the RTC enable */
+static uint64 host_cycles;
+static uint64 host_time_ns;
+static uint64 host_time_rem;
+static uint64 host_core_cycles;              /* cycles out of the sleeps */
+static uint64 host_cyccnt_cycles;            /* host_core_cycles at the last CYCCNT update */
+static uint32 host_cyccnt_presented;         /* value left in DWT_CYCCNT at the last access */
+static uint32 host_access_cycles = HOST_DEFAULT_ACCESS_CYCLES;
+static uint64 host_wakeup_ns;                /* next call of the idle hook, 0 : every HOST_IDLE_STEP_NS */
+
+static boolean host_initialized = FALSE;
+static Host_AccessHookType host_access_hook;
+static Host_OutputHookType host_output_hook;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+static uint32 host_TimerCcrRegister(TimxType * tim, uint8 Channel)
+{
+	switch (Channel)
+	{
+	case 1: return tim->CCR1;
+	case 2: return tim->CCR2;
+	case 3: return tim->CCR3;
+	default: return tim->CCR4;
+	}
+}
+
+/* Compare value in use : the preload value is loaded at update events when OCxPE is set */
+static uint32 host_TimerCcr(uint8 Timer, uint8 Channel)
+{
+	TimxType * tim = &host_tim[Timer];
+	uint32 ccmr = (Channel <= 2) ? tim->CCMR1 : tim->CCMR2;
+	uint8 shift = ((Channel - 1) % 2) * 8;
+
+	if (BIT_IS_SET(ccmr, shift + 3))
+	{
+		return host_tim_state[Timer].CcrShadow[Channel - 1];
+	}
+	return host_TimerCcrRegister(tim, Channel);
+}
+
+/* Flag set by the hardware, visible to the software as already read */
+static void host_TimerSetFlag(uint8 Timer, uint8 Flag)
+{
+	SET_BIT(host_tim[Timer].SR, Flag);
+	SET_BIT(host_tim_state[Timer].SrPresented, Flag);
+}
+
+/* Channel is an output compare channel (CCxS = 00) */
+static boolean host_TimerIsCompare(TimxType * tim, uint8 Channel)
+{
+	uint32 ccmr = (Channel <= 2) ? tim->CCMR1 : tim->CCMR2;
+	uint8 shift = ((Channel - 1) % 2) * 8;
+	return ((ccmr >> shift) & 0x03) == 0;
+}
+
+/* Output compare mode (OCxM) of a channel */
+static uint8 host_TimerOcMode(TimxType * tim, uint8 Channel)
+{
+	uint32 ccmr = (Channel <= 2) ? tim->CCMR1 : tim->CCMR2;
+	uint8 shift = ((Channel - 1) % 2) * 8;
+	return (uint8)((ccmr >> (shift + 4)) & 0x07);
+}
+
+/* Count compare matches of a channel : flag and output compare reference */
+static void host_TimerMatch(uint8 Timer, uint8 Channel, uint64 Count)
+{
+	host_TimerStateType * state = &host_tim_state[Timer];
+	uint8 mask = (uint8)(1U << (Channel - 1));
+
+	host_TimerSetFlag(Timer, Channel);
+	switch (host_TimerOcMode(&host_tim[Timer], Channel))
+	{
+	case HOST_OC_ACTIVE:
+		state->OcRef |= mask;
+		break;
+	case HOST_OC_INACTIVE:
+		state->OcRef &= (uint8)~mask;
+		break;
+	case HOST_OC_TOGGLE:
+		if ((Count % 2) != 0)
+		{
+			state->OcRef ^= mask;
+		}
+		break;
+	default:
+		/* frozen, forced levels and PWM modes : no change at the match */
+		break;
+	}
+}
+
+static uint32 host_TimerMax(uint8 Timer)
+{
+	/* TIM2 and TIM5 are 32-bit, TIM3 and TIM4 are 16-bit */
+	return ((Timer == 0) || (Timer == 3)) ? 0xFFFFFFFFUL : 0xFFFFUL;
+}
+
+static uint32 host_TimerArr(uint8 Timer)
+{
+	TimxType * tim = &host_tim[Timer];
+	return BIT_IS_SET(tim->CR1, HOST_TIM_ARPE) ? host_tim_state[Timer].ArrShadow : (tim->ARR & host_TimerMax(Timer));
+}
+
+/* Matches of the channels with a compare value in ]From, To], Count times (whole periods) */
+static void host_TimerCompare(uint8 Timer, uint64 From, uint64 To, uint64 Count)
+{
+	TimxType * tim = &host_tim[Timer];
+	uint8 channel;
+	for (channel = 1; channel <= 4; channel++)
+	{
+		uint64 ccr = host_TimerCcr(Timer, channel);
+		if (host_TimerIsCompare(tim, channel) && (ccr > From) && (ccr <= To))
+		{
+			host_TimerMatch(Timer, channel, Count);
+		}
+	}
+}
+
+/* Matches of the channels with a compare value of 0 (counter just restarted) */
+static void host_TimerCompareZero(uint8 Timer, uint64 Count)
+{
+	TimxType * tim = &host_tim[Timer];
+	uint8 channel;
+	for (channel = 1; channel <= 4; channel++)
+	{
+		if (host_TimerIsCompare(tim, channel) && (host_TimerCcr(Timer, channel) == 0))
+		{
+			host_TimerMatch(Timer, channel, Count);
+		}
+	}
+}
+
+/* Update event : load the shadow registers, set UIF and stop in one pulse mode */
+static void host_TimerUpdate(uint8 Timer, boolean SetFlag)
+{
+	TimxType * tim = &host_tim[Timer];
+	host_TimerStateType * state = &host_tim_state[Timer];
+	uint8 channel;
+
+	if (BIT_IS_SET(tim->CR1, HOST_TIM_UDIS))
+	{
+		return;
+	}
+	state->PscShadow = tim->PSC & 0xFFFF;
+	state->ArrShadow = tim->ARR & host_TimerMax(Timer);
+	for (channel = 1; channel <= 4; channel++)
+	{
+		state->CcrShadow[channel - 1] = host_TimerCcrRegister(tim, channel) & host_TimerMax(Timer);
+	}
+	if (SetFlag)
+	{
+		host_TimerSetFlag(Timer, HOST_TIM_UIF);
+	}
+}
+
+static boolean host_TimerClocked(uint8 Timer)
+{
+	return BIT_IS_SET(host_tim[Timer].CR1, HOST_TIM_CEN) && BIT_IS_SET(host_rcc[HOST_RCC_APB1ENR], Timer);
+}
+
+/* Clock units per counter tick (the units are timer clock cycles x APB1 divider) */
+static uint64 host_TimerTickUnits(uint8 Timer)
+{
+	return (uint64)(host_tim_state[Timer].PscShadow + 1) * host_apb1_div;
+}
+
+/* Clock units received by the timers for each core cycle */
+static uint64 host_UnitsPerCycle(void)
+{
+	/* Timers clock is PCLK1 x 2 when APB1 is divided */
+	return (host_apb1_div == 1) ? 1 : 2;
+}
+
+static void host_TimerRun(uint8 Timer, uint64 Units)
+{
+	TimxType * tim = &host_tim[Timer];
+	host_TimerStateType * state = &host_tim_state[Timer];
+
+	if (!host_TimerClocked(Timer))
+	{
+		return;
+	}
+	state->Acc += Units;
+
+	while (BIT_IS_SET(tim->CR1, HOST_TIM_CEN))
+	{
+		uint64 tickUnits = host_TimerTickUnits(Timer);
+		uint64 ticks = state->Acc / tickUnits;
+		uint64 arr = host_TimerArr(Timer);
+		uint64 cnt = tim->CNT & host_TimerMax(Timer);
+		uint64 toUpdate;
+
+		if ((ticks == 0) || (arr == 0))
+		{
+			/* No tick yet, or counter blocked by a null auto reload */
+			break;
+		}
+		toUpdate = (cnt > arr) ? ((uint64)host_TimerMax(Timer) - cnt + 1) : (arr - cnt + 1);
+		if (ticks < toUpdate)
+		{
+			host_TimerCompare(Timer, cnt, cnt + ticks, 1);
+			tim->CNT = (uint32)(cnt + ticks);
+			state->Acc -= ticks * tickUnits;
+			break;
+		}
+
+		/* Counter overflow : update event */
+		host_TimerCompare(Timer, cnt, arr, 1);
+		state->Acc -= toUpdate * tickUnits;
+		tim->CNT = 0;
+		host_TimerUpdate(Timer, TRUE);
+		/* the compare values loaded by the update are used from the counter value 0 */
+		host_TimerCompareZero(Timer, 1);
+		if (BIT_IS_SET(tim->CR1, HOST_TIM_OPM))
+		{
+			CLEAR_BIT(tim->CR1, HOST_TIM_CEN);
+			break;
+		}
+
+		/* Skip the whole periods at once when the shadow registers are stable */
+		if (((tim->PSC & 0xFFFF) == state->PscShadow) &&
+			(BIT_IS_CLEAR(tim->CR1, HOST_TIM_ARPE) || ((tim->ARR & host_TimerMax(Timer)) == state->ArrShadow)))
+		{
+			uint64 periodUnits = ((uint64)host_TimerArr(Timer) + 1) * host_TimerTickUnits(Timer);
+			uint64 periods = (host_TimerArr(Timer) == 0) ? 0 : (state->Acc / periodUnits);
+			if (periods > 0)
+			{
+				state->Acc -= periods * periodUnits;
+				host_TimerSetFlag(Timer, HOST_TIM_UIF);
+				host_TimerCompare(Timer, 0, host_TimerArr(Timer), periods);
+				host_TimerCompareZero(Timer, periods);
+			}
+		}
+	}
+	if (BIT_IS_CLEAR(tim->CR1, HOST_TIM_CEN))
+	{
+		state->Acc = 0;
+	}
+}
+
+/* Core cycles until the next interrupt flag of a timer */
+static uint64 host_TimerNextEvent(uint8 Timer)
+{
+	TimxType * tim = &host_tim[Timer];
+	host_TimerStateType * state = &host_tim_state[Timer];
+	uint64 arr = host_TimerArr(Timer);
+	uint64 cnt = tim->CNT & host_TimerMax(Timer);
+	uint64 ticks = HOST_NEVER;
+	uint64 toUpdate;
+	uint64 units;
+	uint8 channel;
+
+	if (!host_TimerClocked(Timer) || (arr == 0) || ((tim->DIER & HOST_TIM_IRQ_FLAGS) == 0))
+	{
+		return HOST_NEVER;
+	}
+	toUpdate = (cnt > arr) ? ((uint64)host_TimerMax(Timer) - cnt + 1) : (arr - cnt + 1);
+	if (BIT_IS_SET(tim->DIER, HOST_TIM_UIE))
+	{
+		ticks = toUpdate;
+	}
+	for (channel = 1; channel <= 4; channel++)
+	{
+		uint64 ccr = host_TimerCcr(Timer, channel);
+		if (BIT_IS_SET(tim->DIER, channel) && host_TimerIsCompare(tim, channel) && (ccr <= arr))
+		{
+			uint64 toMatch = (ccr > cnt) ? (ccr - cnt) : (toUpdate + ccr);
+			if (toMatch < ticks)
+			{
+				ticks = toMatch;
+			}
+		}
+	}
+	if (ticks == HOST_NEVER)
+	{
+		return HOST_NEVER;
+	}
+	units = ticks * host_TimerTickUnits(Timer) - state->Acc;
+	return (units + host_UnitsPerCycle() - 1) / host_UnitsPerCycle();
+}
+
+static uint32 host_AhbDivider(uint32 Hpre)
+{
+	static const uint16 dividers[8] = { 2, 4, 8, 16, 64, 128, 256, 512 };
+	return (Hpre < 8) ? 1 : dividers[Hpre - 8];
+}
+
+static uint32 host_ApbDivider(uint32 Ppre)
+{
+	return (Ppre < 4) ? 1 : (2UL << (Ppre - 4));
+}
+
+static void host_SyncRcc(void)
+{
+	uint32 cr = host_rcc[HOST_RCC_CR];
+	uint32 cfgr = host_rcc[HOST_RCC_CFGR];
+	uint32 pllcfgr = host_rcc[HOST_RCC_PLLCFGR];
+	uint32 sysclk;
+
+	/* Oscillators and PLL are ready as soon as they are switched on */
+	INSERT_BIT(cr, HOST_RCC_HSION + 1, READ_BIT(cr, HOST_RCC_HSION));
+	INSERT_BIT(cr, HOST_RCC_HSEON + 1, READ_BIT(cr, HOST_RCC_HSEON));
+	INSERT_BIT(cr, HOST_RCC_PLLON + 1, host_pll_locks ? READ_BIT(cr, HOST_RCC_PLLON) : 0);
+	host_rcc[HOST_RCC_CR] = cr;
+	INSERT_BIT(host_rcc[HOST_RCC_CSR], HOST_RCC_LSION + 1, READ_BIT(host_rcc[HOST_RCC_CSR], HOST_RCC_LSION));
+	/* System clock switch status follows the switch */
+	INSERT_2BITS_BLOCK(cfgr, 1, READ_2BITS_BLOCK(cfgr, 0));
+	host_rcc[HOST_RCC_CFGR] = cfgr;
+
+	switch (READ_2BITS_BLOCK(cfgr, 1))
+	{
+	case 1:
+		sysclk = HOST_HSE_FREQ;
+		break;
+	case 2:
+	{
+		uint32 input = BIT_IS_SET(pllcfgr, 22) ? HOST_HSE_FREQ : HOST_HSI_FREQ;
+		uint32 pllm = pllcfgr & 0x3F;
+		uint32 plln = (pllcfgr >> 6) & 0x1FF;
+		uint32 pllp = (((pllcfgr >> 16) & 0x03) + 1) * 2;
+		sysclk = (pllm == 0) ? HOST_HSI_FREQ : (uint32)(((uint64)input / pllm) * plln / pllp);
+		break;
+	}
+	default:
+		sysclk = HOST_HSI_FREQ;
+		break;
+	}
+	host_hclk = sysclk / host_AhbDivider(READ_4BITS_BLOCK(cfgr, 1));
+	host_apb1_div = host_ApbDivider((cfgr >> 10) & 0x07);
+	if (host_hclk == 0)
+	{
+		host_hclk = 1;
+	}
+}
+
+static void host_SyncTimers(void)
+{
+	uint8 timer;
+	uint8 channel;
+	for (timer = 0; timer < HOST_NUM_OF_TIMERS; timer++)
+	{
+		TimxType * tim = &host_tim[timer];
+
+		/* Status flags are cleared by writing 0, writing 1 has no effect */
+		if (tim->SR != host_tim_state[timer].SrPresented)
+		{
+			tim->SR &= host_tim_state[timer].SrPresented;
+		}
+		host_tim_state[timer].SrPresented = tim->SR;
+		if (BIT_IS_SET(tim->EGR, HOST_TIM_UG))
+		{
+			/* Software update generation : restart the counter and load the shadows */
+			tim->CNT = 0;
+			host_tim_state[timer].Acc = 0;
+			host_TimerUpdate(timer, BIT_IS_CLEAR(tim->CR1, HOST_TIM_URS));
+		}
+		tim->EGR = 0;
+		for (channel = 1; channel <= 4; channel++)
+		{
+			/* Forced levels apply at once */
+			uint8 mode = host_TimerOcMode(tim, channel);
+			if (mode == HOST_OC_FORCE_INACTIVE)
+			{
+				host_tim_state[timer].OcRef &= (uint8)~(1U << (channel - 1));
+			}
+			else if (mode == HOST_OC_FORCE_ACTIVE)
+			{
+				host_tim_state[timer].OcRef |= (uint8)(1U << (channel - 1));
+			}
+		}
+		if (BIT_IS_CLEAR(tim->CR1, HOST_TIM_ARPE))
+		{
+			host_tim_state[timer].ArrShadow = tim->ARR & host_TimerMax(timer);
+		}
+	}
+}
+
+static void host_SyncNvic(void)
+{
+	uint8 index;
+	for (index = 0; index < 8; index++)
+	{
+		/* Set registers : ones set, read back the state. Clear registers : ones clear, read back 0 */
+		host_enabled[index] |= host_nvic.ISER[index];
+		host_enabled[index] &= ~host_nvic.ICER[index];
+		host_pending[index] |= host_nvic.ISPR[index];
+		host_pending[index] &= ~host_nvic.ICPR[index];
+		host_nvic.ISER[index] = host_enabled[index];
+		host_nvic.ICER[index] = 0;
+		host_nvic.ISPR[index] = host_pending[index];
+		host_nvic.ICPR[index] = 0;
+		host_nvic.IABR[index] = host_active[index];
+	}
+	if (host_stir != HOST_STIR_IDLE)
+	{
+		uint32 irq = host_stir & 0x1FF;
+		if (irq < HOST_NUM_OF_IRQS)
+		{
+			SET_BIT(host_pending[irq / 32], irq % 32);
+		}
+		host_stir = HOST_STIR_IDLE;
+	}
+}
+
+/* Level of a pin driven by a timer channel (alternate function), FALSE if no enabled channel drives it */
+static boolean host_AfOutput(uint8 Port, uint8 Pin, uint8 * Level)
+{
+	GpioType * gpio = &host_gpio[Port];
+	uint8 af = (Pin < 8) ? READ_4BITS_BLOCK(gpio->GPIO_AFRL, Pin) : READ_4BITS_BLOCK(gpio->GPIO_AFRH, Pin - 8);
+	uint8 index;
+
+	for (index = 0; index < (sizeof(host_af_channels) / sizeof(host_af_channels[0])); index++)
+	{
+		const host_AfChannelType * map = &host_af_channels[index];
+		if ((map->Port == Port) && (map->Pin == Pin) && (map->Af == af))
+		{
+			TimxType * tim = &host_tim[map->Timer];
+			uint8 shift = (map->Channel - 1) * 4;
+			if (BIT_IS_CLEAR(tim->CCER, shift))
+			{
+				return FALSE;
+			}
+			/* CCxP inverts the reference */
+			*Level = READ_BIT(host_tim_state[map->Timer].OcRef, map->Channel - 1) ^ READ_BIT(tim->CCER, shift + 1);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void host_SyncGpio(void)
+{
+	uint8 port;
+	for (port = 0; port < NUM_OF_PORTS; port++)
+	{
+		GpioType * gpio = &host_gpio[port];
+		uint16 idr = 0;
+		uint16 output;
+		uint8 pin;
+
+		if (gpio->GPIO_BSRR != 0)
+		{
+			/* Reset bits in the high half word, set bits have priority */
+			gpio->GPIO_ODR &= ~(gpio->GPIO_BSRR >> 16);
+			gpio->GPIO_ODR |= gpio->GPIO_BSRR & 0xFFFF;
+			gpio->GPIO_BSRR = 0;
+		}
+		gpio->GPIO_ODR &= 0xFFFF;
+		output = (uint16)gpio->GPIO_ODR;
+		for (pin = 0; pin < NUM_OF_PINS_PER_PORT; pin++)
+		{
+			uint8 level;
+			if ((READ_2BITS_BLOCK(gpio->GPIO_MODER, pin) == GPIO_AF) && host_AfOutput(port, pin, &level))
+			{
+				INSERT_BIT(output, pin, level);
+			}
+		}
+		if (output != host_last_output[port])
+		{
+			uint16 oldOutput = host_last_output[port];
+			host_last_output[port] = output;
+			if (host_output_hook != 0)
+			{
+				host_output_hook(port, oldOutput, output);
+			}
+		}
+
+		for (pin = 0; pin < NUM_OF_PINS_PER_PORT; pin++)
+		{
+			uint8 level;
+			uint8 mode = READ_2BITS_BLOCK(gpio->GPIO_MODER, pin);
+			if ((mode == GPIO_OUTPUT) || ((mode == GPIO_AF) && host_AfOutput(port, pin, &level)))
+			{
+				level = READ_BIT(output, pin);
+			}
+			else if (BIT_IS_SET(host_driven[port], pin))
+			{
+				level = READ_BIT(host_input[port], pin);
+			}
+			else
+			{
+				level = (READ_2BITS_BLOCK(gpio->GPIO_PUPDR, pin) == GPIO_PULL_UP) ? 1 : 0;
+			}
+			idr |= (uint16)(level << pin);
+		}
+		gpio->GPIO_IDR = idr;
+	}
+}
+
+static uint8 host_LinePort(uint8 Line)
+{
+	uint16 exticr;
+	uint8 code;
+
+	switch (Line / 4)
+	{
+	case 0: exticr = host_syscfg.EXTICR1; break;
+	case 1: exticr = host_syscfg.EXTICR2; break;
+	case 2: exticr = host_syscfg.EXTICR3; break;
+	default: exticr = host_syscfg.EXTICR4; break;
+	}
+	code = READ_4BITS_BLOCK(exticr, Line % 4);
+	/* Port H is selected with code 7 */
+	return (code == 7) ? GPIO_H : ((code < GPIO_H) ? code : NUM_OF_PORTS);
+}
+
+static void host_SyncExti(void)
+{
+	uint32 level = 0;
+	uint32 edges;
+	uint32 newSwier;
+	uint8 line;
+
+	/* A written EXTI_PR value : the ones clear the pending lines */
+	if ((host_exti.PR & 0xFFFF) != host_pr_presented)
+	{
+		uint32 cleared = host_exti.PR & host_pr;
+		host_pr &= ~cleared;
+		host_swier &= ~cleared;
+		host_exti.SWIER &= ~cleared;
+		if (host_nesting > 0)
+		{
+			/* Lines cleared by the running handler are acknowledged */
+			host_active_lines[host_nesting - 1] &= ~cleared;
+		}
+	}
+
+	/* Software interrupt event on a 0 to 1 write */
+	newSwier = host_exti.SWIER & 0xFFFF & ~host_swier;
+	host_pr |= newSwier & host_exti.IMR;
+	host_swier = host_exti.SWIER & 0xFFFF;
+
+	/* Edge detection on the selected port of each line */
+	for (line = 0; line < HOST_NUM_OF_LINES; line++)
+	{
+		uint8 port = host_LinePort(line);
+		if ((port < NUM_OF_PORTS) && BIT_IS_SET(host_gpio[port].GPIO_IDR, line))
+		{
+			SET_BIT(level, line);
+		}
+	}
+	edges = ((level & ~host_line_level) & host_exti.RTSR) | ((~level & host_line_level) & host_exti.FTSR);
+	host_line_level = level;
+	host_pr |= edges & host_exti.IMR & 0xFFFF;
+
+	host_exti.PR = host_pr;
+	host_pr_presented = host_pr;
+}
+
+/* Pend an interrupt request, a request held during its own handler pends again at the exit */
+static void host_Request(uint8 Irq)
+{
+	if (BIT_IS_CLEAR(host_active[Irq / 32], Irq % 32))
+	{
+		SET_BIT(host_pending[Irq / 32], Irq % 32);
+	}
+}
+
+/* Peripherals interrupt requests are latched in the NVIC pending bits */
+static void host_LatchRequests(void)
+{
+	uint8 index;
+	for (index = 0; index < HOST_NUM_OF_LINES; index++)
+	{
+		if (BIT_IS_SET(host_pr, index))
+		{
+			host_Request(host_line_irq[index]);
+		}
+	}
+	for (index = 0; index < HOST_NUM_OF_TIMERS; index++)
+	{
+		if ((host_tim[index].SR & host_tim[index].DIER & HOST_TIM_IRQ_FLAGS) != 0)
+		{
+			host_Request(host_timer_irq[index]);
+		}
+	}
+	for (index = 0; index < 8; index++)
+	{
+		host_nvic.ISPR[index] = host_pending[index];
+	}
+}
+
+/* AIRCR : PRIGROUP is written only with the VECTKEY, reads give VECTKEYSTAT */
+static void host_SyncScb(void)
+{
+	uint32 aircr = host_scb[HOST_SCB_AIRCR];
+
+	if ((aircr >> 16) == HOST_AIRCR_VECTKEY)
+	{
+		host_prigroup = (uint8)((aircr >> HOST_AIRCR_PRIGROUP) & 0x07);
+	}
+	host_scb[HOST_SCB_AIRCR] = (HOST_AIRCR_VECTKEYSTAT << 16) | ((uint32)host_prigroup << HOST_AIRCR_PRIGROUP);
+}
+
+/* CYCCNT : counts the core cycles with TRCENA and CYCCNTENA, a write sets the count */
+static void host_SyncDwt(void)
+{
+	if (host_dwt[HOST_DWT_CYCCNT] != host_cyccnt_presented)
+	{
+		/* written since the last access */
+		host_cyccnt_cycles = host_core_cycles;
+	}
+	if (BIT_IS_SET(host_scb[HOST_SCB_DEMCR], HOST_DEMCR_TRCENA) &&
+		BIT_IS_SET(host_dwt[HOST_DWT_CTRL], HOST_DWT_CYCCNTENA))
+	{
+		host_dwt[HOST_DWT_CYCCNT] += (uint32)(host_core_cycles - host_cyccnt_cycles);
+	}
+	host_cyccnt_cycles = host_core_cycles;
+	host_cyccnt_presented = host_dwt[HOST_DWT_CYCCNT];
+}
+
+/* RTC : counts the virtual time (Stop mode included) once enabled on LSI, with the prescalers of PRER */
+static void host_SyncRtc(void)
+{
+	uint32 bdcr = host_rcc[HOST_RCC_BDCR];
+	uint64 asyncDiv = ((host_rtc[HOST_RTC_PRER] >> 16) & 0x7F) + 1;
+	uint64 syncDiv = (host_rtc[HOST_RTC_PRER] & 0x7FFF) + 1;
+	uint64 subseconds;
+	uint32 seconds;
+
+	if (!BIT_IS_SET(bdcr, HOST_RCC_RTCEN) || (((bdcr >> HOST_RCC_RTCSEL) & 0x03) != HOST_RCC_RTCSEL_LSI) ||
+		!BIT_IS_SET(host_rcc[HOST_RCC_CSR], HOST_RCC_LSION + 1))
+	{
+		host_rtc_running = FALSE;
+		return;
+	}
+	if (!host_rtc_running)
+	{
+		host_rtc_running = TRUE;
+		host_rtc_origin_ns = host_time_ns;
+	}
+	subseconds = ((host_time_ns - host_rtc_origin_ns) * HOST_LSI_FREQ / 1000000000ULL) / asyncDiv;
+	seconds = (uint32)((subseconds / syncDiv) % HOST_SECONDS_PER_DAY);
+	host_rtc[HOST_RTC_SSR] = (uint32)(syncDiv - 1 - (subseconds % syncDiv));
+	/* BCD hours, minutes and seconds */
+	host_rtc[HOST_RTC_TR] = ((seconds / 36000) << 20) | (((seconds / 3600) % 10) << 16) |
+	                        (((seconds / 600) % 6) << 12) | (((seconds / 60) % 10) << 8) |
+	                        (((seconds % 60) / 10) << 4) | (seconds % 10);
+}
+
+static void host_Sync(void)
+{
+	host_SyncScb();
+	host_SyncDwt();
+	host_SyncRcc();
+	host_SyncRtc();
+	host_SyncTimers();
+	host_SyncNvic();
+	host_SyncGpio();
+	host_SyncExti();
+	host_LatchRequests();
+}
+
+/* Move the virtual time and the timers */
+static void host_Run(uint64 Cycles)
+{
+	uint64 units = Cycles * host_UnitsPerCycle();
+	uint64 seconds = Cycles / host_hclk;
+	uint64 rest = (Cycles % host_hclk) * 1000000000ULL + host_time_rem;
+	uint8 timer;
+
+	for (timer = 0; (timer < HOST_NUM_OF_TIMERS) && !host_stopped; timer++)
+	{
+		host_TimerRun(timer, units);
+	}
+	host_cycles += Cycles;
+	if (!host_sleeping)
+	{
+		host_core_cycles += Cycles;
+	}
+	host_time_ns += seconds * 1000000000ULL + rest / host_hclk;
+	host_time_rem = rest % host_hclk;
+}
+
+static uint16 host_IrqPriority(uint8 Irq)
+{
+	/* 4 priority bits implemented (upper half of the byte) */
+	return ((uint8 *)host_nvic.IPR)[Irq] & 0xF0;
+}
+
+/* Group (preemption) part of a priority, the sub-priority bits are cleared */
+static uint16 host_GroupPriority(uint16 Priority)
+{
+	return Priority & (uint16)(0xFFFFU << (host_prigroup + 1));
+}
+
+/* Group priority of the running code with BASEPRI, without PRIMASK */
+static uint16 host_ActivePriority(void)
+{
+	uint16 active = (host_nesting == 0) ? HOST_THREAD_PRIORITY : host_GroupPriority(host_active_prio[host_nesting - 1]);
+	uint16 basepri = host_GroupPriority(host_basepri & 0xF0);
+
+	/* BASEPRI (not 0) boosts the execution priority to its group priority */
+	return ((basepri != 0) && (basepri < active)) ? basepri : active;
+}
+
+static uint16 host_ExecutionPriority(void)
+{
+	/* PRIMASK boosts the execution priority to 0 */
+	return host_primask ? 0 : host_ActivePriority();
+}
+
+/* Highest priority of the pending and enabled interrupts, HOST_THREAD_PRIORITY if none */
+static uint16 host_PendingPriority(sint32 * Irq)
+{
+	uint16 bestPrio = HOST_THREAD_PRIORITY;
+	uint16 irq;
+
+	*Irq = -1;
+	for (irq = 0; irq < HOST_NUM_OF_IRQS; irq++)
+	{
+		if (BIT_IS_SET(host_pending[irq / 32] & host_enabled[irq / 32], irq % 32) &&
+			(host_IrqPriority((uint8)irq) < bestPrio))
+		{
+			*Irq = irq;
+			bestPrio = host_IrqPriority((uint8)irq);
+		}
+	}
+	return bestPrio;
+}
+
+/* Wakeup from the Stop mode : the system clock is switched back to HSI, PLL and HSE are off */
+static void host_ExitStop(void)
+{
+	if (host_stopped)
+	{
+		host_stopped = FALSE;
+		host_rcc[HOST_RCC_CFGR] &= ~0x03UL;
+		CLEAR_BIT(host_rcc[HOST_RCC_CR], HOST_RCC_PLLON);
+		CLEAR_BIT(host_rcc[HOST_RCC_CR], HOST_RCC_HSEON);
+		host_SyncRcc();
+	}
+}
+
+/* Call the pending interrupts handlers that can preempt the running code */
+static void host_Dispatch(void)
+{
+	while (host_nesting < HOST_MAX_NESTING)
+	{
+		sint32 best;
+		uint16 bestPrio = host_PendingPriority(&best);
+		uint8 irq;
+		uint8 line;
+
+		/* only a higher group priority preempts */
+		if ((best < 0) || (host_GroupPriority(bestPrio) >= host_ExecutionPriority()))
+		{
+			return;
+		}
+
+		/* Exception entry */
+		host_ExitStop();
+		host_entries++;
+		irq = (uint8)best;
+		CLEAR_BIT(host_pending[irq / 32], irq % 32);
+		SET_BIT(host_active[irq / 32], irq % 32);
+		host_nvic.ISPR[irq / 32] = host_pending[irq / 32];
+		host_nvic.IABR[irq / 32] = host_active[irq / 32];
+		host_active_prio[host_nesting] = bestPrio;
+		host_active_irq[host_nesting] = irq;
+		host_active_lines[host_nesting] = 0;
+		for (line = 0; line < HOST_NUM_OF_LINES; line++)
+		{
+			if ((host_line_irq[line] == irq) && BIT_IS_SET(host_pr, line))
+			{
+				SET_BIT(host_active_lines[host_nesting], line);
+			}
+		}
+		host_nesting++;
+
+		if (host_vectors[irq] != 0)
+		{
+			host_vectors[irq]();
+		}
+		else
+		{
+			Host_DefaultHandler();
+		}
+
+		/* Exception return : acknowledge the EXTI lines the handler did not visibly clear */
+		host_Sync();
+		host_nesting--;
+		host_pr &= ~host_active_lines[host_nesting];
+		host_swier &= ~host_active_lines[host_nesting];
+		host_exti.SWIER &= ~host_active_lines[host_nesting];
+		host_exti.PR = host_pr;
+		host_pr_presented = host_pr;
+		CLEAR_BIT(host_active[irq / 32], irq % 32);
+		host_nvic.IABR[irq / 32] = host_active[irq / 32];
+		host_LatchRequests();
+	}
+}
+
+static void host_Init(void)
+{
+	if (!host_initialized)
+	{
+		Host_Reset();
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Host_DefaultHandler(void)
+{
+	uint8 irq = (host_nesting > 0) ? host_active_irq[host_nesting - 1] : 0;
+
+	/* No handler for an enabled interrupt : disable it instead of looping forever */
+	fprintf(stderr, "Host: no handler for IRQ %u, interrupt disabled\n", irq);
+	CLEAR_BIT(host_enabled[irq / 32], irq % 32);
+	host_nvic.ISER[irq / 32] = host_enabled[irq / 32];
+}
+
+void Host_Reset(void)
+{
+	memset(host_gpio, 0, sizeof(host_gpio));
+	memset(host_tim, 0, sizeof(host_tim));
+	memset(host_tim_state, 0, sizeof(host_tim_state));
+	memset(host_rcc, 0, sizeof(host_rcc));
+	memset(&host_exti, 0, sizeof(host_exti));
+	memset(&host_syscfg, 0, sizeof(host_syscfg));
+	memset(&host_nvic, 0, sizeof(host_nvic));
+	memset(host_driven, 0, sizeof(host_driven));
+	memset(host_input, 0, sizeof(host_input));
+	memset(host_last_output, 0, sizeof(host_last_output));
+	memset(host_enabled, 0, sizeof(host_enabled));
+	memset(host_pending, 0, sizeof(host_pending));
+	memset(host_active, 0, sizeof(host_active));
+	memset(host_pwr, 0, sizeof(host_pwr));
+	memset(host_scb, 0, sizeof(host_scb));
+	memset(host_flash, 0, sizeof(host_flash));
+	memset(host_dwt, 0, sizeof(host_dwt));
+	memset(host_rtc, 0, sizeof(host_rtc));
+	host_stir = HOST_STIR_IDLE;
+
+	/* Reset values of the STM32F401 registers */
+	host_gpio[GPIO_A].GPIO_MODER = 0xA8000000;
+	host_gpio[GPIO_A].GPIO_PUPDR = 0x64000000;
+	host_gpio[GPIO_A].GPIO_OSPEEDR = 0x0C000000;
+	host_gpio[GPIO_B].GPIO_MODER = 0x00000280;
+	host_gpio[GPIO_B].GPIO_PUPDR = 0x00000100;
+	host_gpio[GPIO_B].GPIO_OSPEEDR = 0x000000C0;
+	host_rcc[HOST_RCC_CR] = 0x00000083;
+	host_rcc[HOST_RCC_PLLCFGR] = 0x24003010;
+	host_rtc[HOST_RTC_PRER] = HOST_RTC_PRER_RESET;
+
+	host_line_level = 0;
+	host_pr = 0;
+	host_pr_presented = 0;
+	host_swier = 0;
+	host_nesting = 0;
+	host_entries = 0;
+	host_primask = FALSE;
+	host_basepri = 0;
+	host_prigroup = 0;
+	host_stopped = FALSE;
+	host_wakeup_ns = 0;
+	host_pll_locks = TRUE;
+	host_rtc_running = FALSE;
+	host_sleeping = FALSE;
+	host_cycles = 0;
+	host_time_ns = 0;
+	host_time_rem = 0;
+	host_core_cycles = 0;
+	host_cyccnt_cycles = 0;
+	host_cyccnt_presented = 0;
+	host_initialized = TRUE;
+	host_Sync();
+}
+
+void * Host_Access(uint8 Block)
+{
+	host_Init();
+	/* 1- side effects of the previous writes */
+	host_Sync();
+	/* 2- time of the access */
+	host_Run(host_access_cycles);
+	host_LatchRequests();
+	if (host_access_hook != 0)
+	{
+		host_access_hook(Block);
+	}
+	/* 3- interrupts */
+	host_Dispatch();
+	/* the cycle counter after the handlers */
+	host_SyncDwt();
+	return host_blocks[(Block < HOST_NUM_OF_BLOCKS) ? Block : 0];
+}
+
+void Host_SetAccessCycles(uint32 Cycles)
+{
+	host_access_cycles = Cycles;
+}
+
+void Host_AdvanceCycles(uint64 Cycles)
+{
+	host_Init();
+	host_Sync();
+	host_Dispatch();
+	while (Cycles > 0)
+	{
+		uint64 step = Cycles;
+		uint8 timer;
+
+		/* Stop at the next timer interrupt flag to call its handler on time */
+		for (timer = 0; timer < HOST_NUM_OF_TIMERS; timer++)
+		{
+			uint64 next = host_TimerNextEvent(timer);
+			if (next < step)
+			{
+				step = (next == 0) ? 1 : next;
+			}
+		}
+		host_Run(step);
+		host_Sync();
+		host_Dispatch();
+		Cycles -= step;
+	}
+}
+
+void Host_AdvanceTime(uint64 Nanoseconds)
+{
+	host_Init();
+	host_SyncRcc();
+	Host_AdvanceCycles((Nanoseconds / 1000000000ULL) * host_hclk +
+	                   ((Nanoseconds % 1000000000ULL) * host_hclk) / 1000000000ULL);
+}
+
+uint64 Host_GetCycles(void)
+{
+	return host_cycles;
+}
+
+uint64 Host_GetTime(void)
+{
+	return host_time_ns;
+}
+
+uint32 Host_GetCoreFreq(void)
+{
+	host_Init();
+	host_SyncRcc();
+	return host_hclk;
+}
+
+void Host_SetPinInput(uint8 PortName, uint8 PinNum, uint8 Level)
+{
+	host_Init();
+	if ((PortName < NUM_OF_PORTS) && (PinNum < NUM_OF_PINS_PER_PORT))
+	{
+		SET_BIT(host_driven[PortName], PinNum);
+		INSERT_BIT(host_input[PortName], PinNum, Level);
+		host_Sync();
+		host_Dispatch();
+	}
+}
+
+void Host_ReleasePinInput(uint8 PortName, uint8 PinNum)
+{
+	host_Init();
+	if ((PortName < NUM_OF_PORTS) && (PinNum < NUM_OF_PINS_PER_PORT))
+	{
+		CLEAR_BIT(host_driven[PortName], PinNum);
+		host_Sync();
+		host_Dispatch();
+	}
+}
+
+uint16 Host_GetPortOutput(uint8 PortName)
+{
+	host_Init();
+	host_Sync();
+	return (PortName < NUM_OF_PORTS) ? host_last_output[PortName] : 0;
+}
+
+void Host_SetPrimask(boolean Masked)
+{
+	host_Init();
+	host_primask = Masked;
+	if (!Masked)
+	{
+		host_Sync();
+		host_Dispatch();
+	}
+}
+
+void Host_SetBasepri(uint8 Basepri, boolean RaiseOnly)
+{
+	uint8 level = Basepri & 0xF0;
+	uint8 current = host_basepri & 0xF0;
+
+	host_Init();
+	/* basepri_max : only a higher priority mask is taken (0 : no mask) */
+	if (!RaiseOnly || ((level != 0) && ((current == 0) || (level < current))))
+	{
+		host_basepri = Basepri;
+	}
+	host_Sync();
+	host_Dispatch();
+}
+
+uint8 Host_GetBasepri(void)
+{
+	host_Init();
+	return host_basepri;
+}
+
+void Host_WaitForInterrupt(void)
+{
+	uint32 entries;
+	sint32 irq;
+
+	host_Init();
+	host_Sync();
+	host_Dispatch();
+	entries = host_entries;
+	/* SLEEPDEEP : Stop mode (Standby is not simulated) */
+	host_stopped = BIT_IS_SET(host_scb[HOST_SCB_SCR], HOST_SCB_SLEEPDEEP) &&
+	               BIT_IS_CLEAR(host_pwr[HOST_PWR_CR], HOST_PWR_PDDS);
+
+	/* A pending interrupt that could preempt without PRIMASK ends the sleep */
+	host_sleeping = TRUE;
+	while ((host_GroupPriority(host_PendingPriority(&irq)) >= host_ActivePriority()) && (host_entries == entries))
+	{
+		uint64 step = (host_hclk * HOST_IDLE_STEP_NS) / 1000000000ULL;
+		uint8 timer;
+
+		/* Discrete events : no idle step before the wakeup time of the test program */
+		if (host_wakeup_ns > host_time_ns)
+		{
+			uint64 wait = host_wakeup_ns - host_time_ns;
+			step = (wait / 1000000000ULL) * host_hclk +
+			       ((wait % 1000000000ULL) * host_hclk + 999999999ULL) / 1000000000ULL;
+		}
+		/* Jump to the next timer interrupt flag, the test program runs at each idle step */
+		for (timer = 0; (timer < HOST_NUM_OF_TIMERS) && !host_stopped; timer++)
+		{
+			uint64 next = host_TimerNextEvent(timer);
+			if (next < step)
+			{
+				step = next;
+			}
+		}
+		host_Run((step == 0) ? 1 : step);
+		host_Sync();
+		if (host_access_hook != 0)
+		{
+			host_access_hook(HOST_IDLE);
+		}
+		host_Sync();
+	}
+	host_sleeping = FALSE;
+	host_ExitStop();
+	host_Dispatch();
+}
+
+void Host_SetWakeupTime(uint64 Nanoseconds)
+{
+	host_wakeup_ns = Nanoseconds;
+}
+
+void Host_SetPllLock(boolean Locks)
+{
+	host_pll_locks = Locks;
+}
+
+void Host_SetAccessHook(Host_AccessHookType Hook)
+{
+	host_access_hook = Hook;
+}
+
+void Host_SetOutputHook(Host_OutputHookType Hook)
+{
+	host_output_hook = Hook;
+}
+
+#endif /* HOST_BACKEND */
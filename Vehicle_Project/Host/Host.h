@@ -0,0 +1,249 @@
+/* *****************************************************************************
+ * Module: Host
+ *
+ * File Name: Host.h
+ *
+ * Description: Header file for the host register backend (simulated peripherals on Linux)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include "Std_Types.h"
+
+/* Host Backend Documentation */
+/* Simulated STM32F401 peripherals to build and run the drivers on a Linux host.
+ * Build every source file with -DHOST_BACKEND, the private headers of the drivers then
+ * point GPIO, RCC, FLASH, TIM2..TIM5, EXTI, SYSCFG, NVIC, PWR, RTC, SCB and DWT to simulated register files and
+ * every register block access goes through Host_Access().
+ *   gcc -DHOST_BACKEND -ILib -IGpio -IRcc -INVIC -IGPT -IShadow -IPwm -ISwTimer -IPower -IDebounce \
+ *       -IEventQueue -ILatency -IInject -IFsm -IPattern -IHost Gpio/Gpio.c Rcc/Rcc.c NVIC/NVIC.c \
+ *       GPT/GPT.c Shadow/Shadow.c Pwm/Pwm.c SwTimer/SwTimer.c Power/Power.c Debounce/Debounce.c \
+ *       EventQueue/EventQueue.c Latency/Latency.c Inject/Inject.c Fsm/Fsm.c Pattern/Pattern.c \
+ *       Host/Host.c test.c
+ * Host/build.sh builds the test program of the drivers Host/Test.c and the simulator Host/Sim.c
+ * (sh Host/build.sh, then _host/host_test and _host/sim).
+ * Host/Sim.c is the virtual time simulator of the application (src/main.c built with -Dmain=app_main) :
+ * scripted door scenarios, LED transitions log and timing checks (see its documentation).
+ * Host_Access() is the read/write hook of the registers :
+ * 1. It applies the side effects of the previous writes (BSRR, NVIC set/clear registers,
+ *    NVIC_STIR, EXTI_SWIER, EXTI_PR write 1 to clear, TIMx_SR write 0 to clear, TIMx_EGR,
+ *    RCC ready bits : an oscillator is ready once switched on, the PLL unless Host_SetPllLock(FALSE)).
+ * 2. It advances the virtual time by Host_SetAccessCycles() core cycles, so TIMx_CNT
+ *    counts with the virtual time using the PSC/ARR values and the RCC bus prescalers
+ *    (PSC, and ARR / CCRx when preloaded, are taken at the update events).
+ * 3. It samples the pins, detects the EXTI edges and calls the pending interrupt handlers
+ *    (EXTI0_IRQHandler, TIM2_IRQHandler, ...) by priority, with nesting.
+ * The core instructions of Cpu.h are simulated too : PRIMASK and BASEPRI hold the interrupts
+ * (preemption by group priority, AIRCR PRIGROUP) and WFI
+ * (Host_WaitForInterrupt) jumps the virtual time to the next interrupt, in steps of 1 ms with
+ * a call of the access hook (block HOST_IDLE) at each step, or in one step up to the time set by
+ * Host_SetWakeupTime() (discrete events : the sleeps cost nothing however long they are). With SLEEPDEEP the timers are
+ * stopped (Stop mode) and the system clock is back on HSI at the wakeup, the RTC (on LSI, time of
+ * day in RTC_TR and RTC_SSR from its enable) keeps counting. The DWT cycle counter
+ * (DEMCR TRCENA and CYCCNTENA) counts the core cycles out of the sleeps.
+ * The test program drives the inputs with Host_SetPinInput(), lets time pass with
+ * Host_AdvanceCycles() / Host_AdvanceTime() and observes the outputs with Host_GetPortOutput()
+ * or an output hook. The output level of a pin is its ODR bit, or for an alternate function pin
+ * the output compare level of its TIM2..TIM5 channel (match modes and forced levels, the PWM modes
+ * are not simulated on the pins).
+ * Limitation : a write of EXTI_PR equal to the pending value read before cannot be seen,
+ * the pending lines of an EXTI handler are acknowledged when the handler returns.
+ *  */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Simulated register blocks */
+#define HOST_GPIOA       0
+#define HOST_GPIOB       1
+#define HOST_GPIOC       2
+#define HOST_GPIOD       3
+#define HOST_GPIOE       4
+#define HOST_GPIOH       5
+#define HOST_TIM2        6
+#define HOST_TIM3        7
+#define HOST_TIM4        8
+#define HOST_TIM5        9
+#define HOST_RCC         10
+#define HOST_EXTI        11
+#define HOST_SYSCFG      12
+#define HOST_NVIC        13
+#define HOST_NVIC_STIR   14
+#define HOST_PWR         15
+#define HOST_SCB         16
+#define HOST_FLASH       17
+#define HOST_DWT         18
+#define HOST_RTC         19
+#define HOST_NUM_OF_BLOCKS 20
+
+/* Block given to the access hook while the core sleeps (no register access) */
+#define HOST_IDLE        HOST_NUM_OF_BLOCKS
+
+/* Simulated clocks */
+#define HOST_HSI_FREQ    16000000UL
+#define HOST_HSE_FREQ    8000000UL
+#define HOST_LSI_FREQ    32000UL
+
+/* Default cost of one register block access in core cycles */
+#define HOST_DEFAULT_ACCESS_CYCLES 4
+
+/* Number of interrupts of the vector table (STM32F401) */
+#define HOST_NUM_OF_IRQS 85
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Called on each access of a register block, and with HOST_IDLE while the core sleeps */
+typedef void (*Host_AccessHookType)(uint8 Block);
+
+/* Called when the output levels of a port change (ODR and timer channels on alternate functions) */
+typedef void (*Host_OutputHookType)(uint8 PortName, uint16 OldOutput, uint16 NewOutput);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Host_Reset
+ * Description :
+ * Put all the simulated registers in their reset state and restart the virtual time from 0.
+ */
+void Host_Reset(void);
+
+/*
+ * Function : Host_Access
+ * Input : Block
+ * Output : address of the simulated registers of the block
+ * Description :
+ * Register hook used by the private headers of the drivers on each register block access.
+ */
+void * Host_Access(uint8 Block);
+
+/*
+ * Function : Host_SetAccessCycles
+ * Input : Cycles
+ * Description :
+ * Set the virtual core cycles consumed by each register block access.
+ */
+void Host_SetAccessCycles(uint32 Cycles);
+
+/*
+ * Function : Host_AdvanceCycles
+ * Input : Cycles
+ * Description :
+ * Let the virtual time pass for Cycles core cycles, the interrupts are handled at their exact cycle.
+ */
+void Host_AdvanceCycles(uint64 Cycles);
+
+/*
+ * Function : Host_AdvanceTime
+ * Input : Nanoseconds
+ * Description :
+ * Let the virtual time pass for Nanoseconds at the current core clock.
+ */
+void Host_AdvanceTime(uint64 Nanoseconds);
+
+/*
+ * Function : Host_GetCycles / Host_GetTime
+ * Description :
+ * Return the virtual time in core cycles / in nanoseconds since Host_Reset.
+ */
+uint64 Host_GetCycles(void);
+uint64 Host_GetTime(void);
+
+/*
+ * Function : Host_GetCoreFreq
+ * Description :
+ * Return the simulated core clock (HCLK) in Hz from the RCC configuration.
+ */
+uint32 Host_GetCoreFreq(void);
+
+/*
+ * Function : Host_SetPinInput
+ * Input : PortName, PinNum, Level
+ * Description :
+ * Drive an external level on a pin, the pin is read in IDR when it is not an output
+ * and the EXTI edge detection runs immediately.
+ */
+void Host_SetPinInput(uint8 PortName, uint8 PinNum, uint8 Level);
+
+/*
+ * Function : Host_ReleasePinInput
+ * Input : PortName, PinNum
+ * Description :
+ * Stop driving a pin, the pin reads its pull up / pull down level.
+ */
+void Host_ReleasePinInput(uint8 PortName, uint8 PinNum);
+
+/*
+ * Function : Host_GetPortOutput
+ * Input : PortName
+ * Output : output levels of the port (ODR and timer channels on alternate functions)
+ */
+uint16 Host_GetPortOutput(uint8 PortName);
+
+/*
+ * Function : Host_SetPrimask
+ * Input : Masked
+ * Description :
+ * Set / clear the interrupt mask of the core (cpsid i / cpsie i), the pending interrupts
+ * are taken when the mask is cleared.
+ */
+void Host_SetPrimask(boolean Masked);
+
+/*
+ * Function : Host_SetBasepri
+ * Input : Basepri, RaiseOnly
+ * Description :
+ * Write BASEPRI (msr basepri), with RaiseOnly only when it masks more (msr basepri_max),
+ * the pending interrupts it does not hold any more are taken.
+ */
+void Host_SetBasepri(uint8 Basepri, boolean RaiseOnly);
+
+/*
+ * Function : Host_GetBasepri
+ * Output : uint8 BASEPRI (mrs basepri)
+ */
+uint8 Host_GetBasepri(void);
+
+/*
+ * Function : Host_WaitForInterrupt
+ * Description :
+ * Sleep (wfi) : let the virtual time pass till an interrupt is pending and enabled with a
+ * priority that could preempt the running code (PRIMASK does not hold the wakeup).
+ */
+void Host_WaitForInterrupt(void);
+
+/*
+ * Function : Host_SetWakeupTime
+ * Input : Nanoseconds
+ * Description :
+ * Virtual time of the next action of the test program : a sleep calls the access hook (HOST_IDLE)
+ * at this time or at the next interrupt, not every 1 ms. Once the time is passed, or with 0,
+ * the sleeps are back to steps of 1 ms.
+ */
+void Host_SetWakeupTime(uint64 Nanoseconds);
+
+/*
+ * Function : Host_SetPllLock
+ * Input : Locks
+ * Description :
+ * With FALSE the PLL never gets ready (PLLRDY stays low), TRUE after Host_Reset.
+ */
+void Host_SetPllLock(boolean Locks);
+
+/*
+ * Function : Host_SetAccessHook / Host_SetOutputHook
+ * Description :
+ * Register the hooks called on each register block access / on each output change (0 to remove).
+ */
+void Host_SetAccessHook(Host_AccessHookType Hook);
+void Host_SetOutputHook(Host_OutputHookType Hook);
+
+#endif /* HOST_H_ */
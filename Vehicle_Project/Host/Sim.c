@@ -0,0 +1,452 @@
+/* *****************************************************************************
+ * Module: Host
+ *
+ * File Name: Sim.c
+ *
+ * Description: Virtual time simulator of the door control unit (scripted scenarios on the host backend)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+/* Simulator Documentation */
+/* Runs the application of src/main.c, unmodified, on the simulated registers of the host backend.
+ * The main of the application is renamed app_main, the simulator drives the push buttons from a
+ * scripted scenario and records every LED transition with its virtual time.
+ * Host/build.sh builds it with the host test program (sh Host/build.sh, then _host/sim) :
+ *   gcc -DHOST_BACKEND <include and source files of Host.h> -Dmain=app_main -c src/main.c -o app_main.o
+ *   gcc -DHOST_BACKEND <include and source files of Host.h> Host/Sim.c app_main.o -o sim
+ *   ./sim                 list the scenarios
+ *   ./sim [-q] scenario   run a scenario (-q : only the failed checks and the summary)
+ * The virtual time only moves with the simulated core : the sleeps of the application jump to the
+ * next interrupt or to the next step of the scenario (Host_SetWakeupTime), so hours of idle door
+ * cost nothing. The exit status is 0 when all the checks of the scenario passed, 1 otherwise.
+ * At the end of a scenario the measures of the application are printed : idle (Sleep and Stop) and
+ * busy time (Power_GetStats), with the running idle not measured yet they add up to the virtual time, events dropped (EventQueue_GetOverflowCount) and the latency probes (Latency_GetStats).
+ * The ambient light is a PWM output (not simulated on its pin) : its level is the duty cycle of
+ * the channel, OFF, FADING while it ramps or is dimmed, ON at full duty.
+ *  */
+
+#ifdef HOST_BACKEND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Std_Types.h"
+#include "Host.h"
+#include "Gpio.h"
+#include "Pwm.h"
+#include "Power.h"
+#include "Latency.h"
+#include "EventQueue.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Board wiring of src/main.c : active low push buttons on PORT A, LEDs on PORT B */
+#define SIM_HANDLE_BUTTON     2
+#define SIM_DOOR_BUTTON       3
+#define SIM_VEHICLE_LOCK_PIN  5
+#define SIM_HAZARD_LIGHT_PIN  6
+#define SIM_AMBIENT_TIMER     PWM_TIM4
+#define SIM_AMBIENT_CHANNEL   PWM_CHANNEL_2
+
+/* LEDs */
+#define SIM_VEHICLE_LOCK  0
+#define SIM_HAZARD_LIGHT  1
+#define SIM_AMBIENT_LIGHT 2
+#define SIM_NUM_OF_LEDS   3
+
+/* LEDs levels */
+#define SIM_OFF     0
+#define SIM_ON      1
+#define SIM_FADING  2   /* ambient light only */
+
+/* Scenario steps */
+#define SIM_PRESS   0   /* Target : button, pressed for SIM_PRESS_MS then released */
+#define SIM_WAIT    1   /* wait Time ms */
+#define SIM_EXPECT  2   /* Target : LED, check that it is at Level now */
+#define SIM_REPEAT  3   /* back to the first step till the scenario has run for Time ms */
+#define SIM_END     4
+
+/* Time a button is held by SIM_PRESS */
+#define SIM_PRESS_MS  100
+
+#define SIM_NS_PER_MS 1000000ULL
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 Kind;     /* SIM_PRESS, SIM_WAIT, SIM_EXPECT, SIM_REPEAT, SIM_END */
+	uint8 Target;   /* button (SIM_PRESS) or LED (SIM_EXPECT) */
+	uint8 Level;    /* expected level (SIM_EXPECT) */
+	uint32 Time;    /* ms (SIM_WAIT, SIM_REPEAT) */
+} Sim_StepType;
+
+typedef struct {
+	const char * Name;
+	const char * Description;
+	const Sim_StepType * Steps;
+} Sim_ScenarioType;
+
+/*******************************************************************************
+ *                              Scenarios                                      *
+ *******************************************************************************/
+
+#define PRESS(BUTTON)        { SIM_PRESS, (BUTTON), 0, 0 }
+#define WAIT(MS)             { SIM_WAIT, 0, 0, (MS) }
+#define EXPECT(LED, LEVEL)   { SIM_EXPECT, (LED), (LEVEL), 0 }
+#define REPEAT(MS)           { SIM_REPEAT, 0, 0, (MS) }
+#define END()                { SIM_END, 0, 0, 0 }
+
+/* The door is opened 0.1 s before the 10 s relock, closed and left alone : the anti theft lock
+ * comes back 10 s after the closing */
+static const Sim_StepType open_before_relock[] = {
+	PRESS(SIM_HANDLE_BUTTON),
+	WAIT(900),
+	EXPECT(SIM_AMBIENT_LIGHT, SIM_ON),
+	WAIT(1200),
+	EXPECT(SIM_AMBIENT_LIGHT, SIM_OFF),     /* dark at the end of the welcome light time */
+	WAIT(7700),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_ON),
+	PRESS(SIM_DOOR_BUTTON),
+	WAIT(100),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_ON),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	WAIT(1000),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_ON),
+	EXPECT(SIM_AMBIENT_LIGHT, SIM_ON),
+	PRESS(SIM_DOOR_BUTTON),
+	WAIT(100),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_OFF),
+	WAIT(1000),
+	EXPECT(SIM_AMBIENT_LIGHT, SIM_OFF),     /* dark at the end of the closing light time */
+	WAIT(8700),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	WAIT(200),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_ON),
+	WAIT(3000),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_OFF),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	END(),
+};
+
+/* Unlocked and left alone : the anti theft lock 10 s after the unlock */
+static const Sim_StepType anti_theft_relock[] = {
+	PRESS(SIM_HANDLE_BUTTON),
+	WAIT(100),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_ON),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_ON),
+	WAIT(9800),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_ON),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	WAIT(200),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_OFF),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_ON),
+	WAIT(3000),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	END(),
+};
+
+/* Unlock, open, close and lock with the handle */
+static const Sim_StepType lock_with_handle[] = {
+	PRESS(SIM_HANDLE_BUTTON),
+	WAIT(2000),
+	PRESS(SIM_DOOR_BUTTON),
+	WAIT(1000),
+	PRESS(SIM_DOOR_BUTTON),
+	WAIT(1000),
+	PRESS(SIM_HANDLE_BUTTON),
+	WAIT(100),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_OFF),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_ON),
+	WAIT(3000),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	EXPECT(SIM_AMBIENT_LIGHT, SIM_OFF),
+	END(),
+};
+
+/* 24 hours of door cycles : unlock, open, close, anti theft lock, then 10 minutes parked */
+static const Sim_StepType soak_24h[] = {
+	PRESS(SIM_HANDLE_BUTTON),
+	WAIT(2000),
+	PRESS(SIM_DOOR_BUTTON),
+	WAIT(2000),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_ON),
+	PRESS(SIM_DOOR_BUTTON),
+	WAIT(9800),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_OFF),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	WAIT(200),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_ON),
+	WAIT(600000),
+	EXPECT(SIM_VEHICLE_LOCK, SIM_OFF),
+	EXPECT(SIM_HAZARD_LIGHT, SIM_OFF),
+	EXPECT(SIM_AMBIENT_LIGHT, SIM_OFF),
+	REPEAT(24UL * 3600UL * 1000UL),
+	END(),
+};
+
+static const Sim_ScenarioType sim_scenarios[] = {
+	{ "open_before_relock", "unlock, wait 9.9 s, open the door, close it, wait for the anti theft lock", open_before_relock },
+	{ "anti_theft_relock",  "unlock and wait for the anti theft lock after 10 s",                       anti_theft_relock },
+	{ "lock_with_handle",   "unlock, open, close, lock with the handle",                                lock_with_handle },
+	{ "soak_24h",           "24 hours of door cycles, the anti theft lock checked at each cycle",       soak_24h },
+};
+
+#define SIM_NUM_OF_SCENARIOS  (sizeof(sim_scenarios) / sizeof(sim_scenarios[0]))
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+static const char * const sim_led_name[SIM_NUM_OF_LEDS] = { "VEHICLE_LOCK", "HAZARD_LIGHT", "AMBIENT_LIGHT" };
+static const char * const sim_level_name[] = { "OFF", "ON", "FADING" };
+
+/* Latency probes of src/main.c */
+static const char * const sim_probe_name[LATENCY_NUM_OF_PROBES] = {
+	"BUTTON_EDGE", "BUTTON_REACTION", "TIMER_REACTION", "DEBOUNCE_TIMER", "LIGHTS_TIMER", "CLOCK_TIMER"
+};
+
+static const Sim_ScenarioType * sim_scenario;
+static boolean sim_quiet = FALSE;
+
+/* Current step, virtual time it is due (ns), button held by a SIM_PRESS */
+static uint32 sim_step;
+static uint64 sim_due;
+static boolean sim_pressing = FALSE;
+
+/* Last levels of the LEDs */
+static uint8 sim_led[SIM_NUM_OF_LEDS];
+
+/* Results */
+static uint32 sim_transitions;
+static uint32 sim_checks;
+static uint32 sim_failures;
+static uint32 sim_cycles;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+static void Sim_PrintTime(uint64 Nanoseconds)
+{
+	printf("%10llu.%03llu ms  ", Nanoseconds / SIM_NS_PER_MS, (Nanoseconds % SIM_NS_PER_MS) / 1000ULL);
+}
+
+/* Record a transition of a LED */
+static void Sim_SetLed(uint8 Led, uint8 Level)
+{
+	if (sim_led[Led] == Level)
+	{
+		return;
+	}
+	sim_led[Led] = Level;
+	sim_transitions++;
+	if (sim_quiet == FALSE)
+	{
+		Sim_PrintTime(Host_GetTime());
+		printf("%-13s %s\n", sim_led_name[Led], sim_level_name[Level]);
+	}
+}
+
+/* Output levels of PORT B : Vehicle Lock LED (ODR) and Hazard Light LED (output compare) */
+static void Sim_Output(uint8 PortName, uint16 OldOutput, uint16 NewOutput)
+{
+	(void)OldOutput;
+	if (PortName != GPIO_B)
+	{
+		return;
+	}
+	Sim_SetLed(SIM_VEHICLE_LOCK, ((NewOutput >> SIM_VEHICLE_LOCK_PIN) & 1U) ? SIM_ON : SIM_OFF);
+	Sim_SetLed(SIM_HAZARD_LIGHT, ((NewOutput >> SIM_HAZARD_LIGHT_PIN) & 1U) ? SIM_ON : SIM_OFF);
+}
+
+/* Level of the Ambient Light LED from the duty cycle of its channel */
+static void Sim_SampleAmbient(void)
+{
+	uint16 duty = Pwm_GetDuty(SIM_AMBIENT_TIMER, SIM_AMBIENT_CHANNEL);
+
+	if (duty == PWM_DUTY_OFF)
+	{
+		Sim_SetLed(SIM_AMBIENT_LIGHT, SIM_OFF);
+	}
+	else if (duty >= PWM_DUTY_MAX)
+	{
+		Sim_SetLed(SIM_AMBIENT_LIGHT, SIM_ON);
+	}
+	else
+	{
+		Sim_SetLed(SIM_AMBIENT_LIGHT, SIM_FADING);
+	}
+}
+
+/* Measures of the application : idle / busy time of the loop, events dropped, response times */
+static void Sim_PrintStats(void)
+{
+	Power_StatsType power;
+	Latency_StatsType latency;
+	uint8 probe;
+
+	uint64 measured;
+
+	Power_GetStats(&power);
+	/* the scenario ends in an idle of the application : it is measured at its wakeup only */
+	measured = power.IdleTicks + power.BusyTicks;
+	printf("  power : %llu us idle (%llu us in Stop), %llu us busy, %llu us of idle running, %lu sleeps, %lu stops\n",
+	       (unsigned long long)power.IdleTicks, (unsigned long long)power.StopTicks,
+	       (unsigned long long)power.BusyTicks, (unsigned long long)((Host_GetTime() / 1000ULL) - measured),
+	       (unsigned long)power.Sleeps, (unsigned long)power.Stops);
+	printf("  event queue : %lu overflows\n", (unsigned long)EventQueue_GetOverflowCount());
+	for (probe = 0; probe < LATENCY_NUM_OF_PROBES; probe++)
+	{
+		(void)Latency_GetStats(probe, &latency);
+		printf("  latency %-15s : %lu measures, min %lu, max %lu cycles\n",
+		       (sim_probe_name[probe] != 0) ? sim_probe_name[probe] : "-",
+		       (unsigned long)latency.Count, (unsigned long)((latency.Count != 0) ? latency.Min : 0),
+		       (unsigned long)latency.Max);
+	}
+}
+
+static void Sim_Finish(void)
+{
+	Sim_PrintStats();
+	printf("%s : %llu ms of virtual time, %lu cycles, %lu LED transitions, %lu checks, %lu failed\n",
+	       sim_scenario->Name, Host_GetTime() / SIM_NS_PER_MS, (unsigned long)sim_cycles,
+	       (unsigned long)sim_transitions, (unsigned long)sim_checks, (unsigned long)sim_failures);
+	exit((sim_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/* Run the steps of the scenario that are due */
+static void Sim_Run(void)
+{
+	while (Host_GetTime() >= sim_due)
+	{
+		const Sim_StepType * step = &sim_scenario->Steps[sim_step];
+
+		switch (step->Kind)
+		{
+		case SIM_PRESS:
+			/* Active low buttons : pressed, then released SIM_PRESS_MS later */
+			Host_SetPinInput(GPIO_A, step->Target, sim_pressing ? HIGH : LOW);
+			sim_pressing = !sim_pressing;
+			if (sim_pressing)
+			{
+				sim_due += SIM_PRESS_MS * SIM_NS_PER_MS;
+			}
+			else
+			{
+				sim_step++;
+			}
+			break;
+
+		case SIM_WAIT:
+			sim_due += (uint64)step->Time * SIM_NS_PER_MS;
+			sim_step++;
+			break;
+
+		case SIM_EXPECT:
+			sim_checks++;
+			if (sim_led[step->Target] != step->Level)
+			{
+				sim_failures++;
+				Sim_PrintTime(Host_GetTime());
+				printf("FAILED step %lu : %s is %s, expected %s\n", (unsigned long)sim_step,
+				       sim_led_name[step->Target], sim_level_name[sim_led[step->Target]], sim_level_name[step->Level]);
+			}
+			sim_step++;
+			break;
+
+		case SIM_REPEAT:
+			sim_cycles++;
+			sim_step = (sim_due < (uint64)step->Time * SIM_NS_PER_MS) ? 0 : sim_step + 1;
+			break;
+
+		default:
+			Sim_Finish();
+			break;
+		}
+	}
+	/* The application sleeps till the next step at most */
+	Host_SetWakeupTime(sim_due);
+}
+
+/* Access hook : called on the register accesses of the application and at the end of its sleeps */
+static void Sim_Hook(uint8 Block)
+{
+	static boolean running = FALSE;
+
+	(void)Block;
+	/* Host_SetPinInput() can call the EXTI handlers, their register accesses come back here */
+	if (running)
+	{
+		return;
+	}
+	running = TRUE;
+	Sim_SampleAmbient();
+	Sim_Run();
+	running = FALSE;
+}
+
+static void Sim_List(void)
+{
+	uint32 index;
+
+	printf("usage : sim [-q] scenario\n");
+	for (index = 0; index < SIM_NUM_OF_SCENARIOS; index++)
+	{
+		printf("  %-20s %s\n", sim_scenarios[index].Name, sim_scenarios[index].Description);
+	}
+}
+
+/*******************************************************************************
+ *                                Main                                         *
+ *******************************************************************************/
+
+int app_main(void);
+
+int main(int argc, char * argv[])
+{
+	uint32 index;
+	int arg = 1;
+
+	if ((argc > arg) && (strcmp(argv[arg], "-q") == 0))
+	{
+		sim_quiet = TRUE;
+		arg++;
+	}
+	if (argc <= arg)
+	{
+		Sim_List();
+		return EXIT_SUCCESS;
+	}
+	for (index = 0; (index < SIM_NUM_OF_SCENARIOS) && (sim_scenario == 0); index++)
+	{
+		if (strcmp(argv[arg], sim_scenarios[index].Name) == 0)
+		{
+			sim_scenario = &sim_scenarios[index];
+		}
+	}
+	if (sim_scenario == 0)
+	{
+		Sim_List();
+		return EXIT_FAILURE;
+	}
+
+	/* Buttons released, the scenario starts 100 ms after the power on */
+	Host_Reset();
+	Host_SetPinInput(GPIO_A, SIM_HANDLE_BUTTON, HIGH);
+	Host_SetPinInput(GPIO_A, SIM_DOOR_BUTTON, HIGH);
+	sim_due = 100 * SIM_NS_PER_MS;
+	Host_SetOutputHook(Sim_Output);
+	Host_SetAccessHook(Sim_Hook);
+
+	/* The application never returns, the simulator exits at the end of the scenario */
+	return app_main();
+}
+
+#endif /* HOST_BACKEND */
@@ -0,0 +1,1061 @@
+/* *****************************************************************************
+ * Module: Host
+ *
+ * File Name: Test.c
+ *
+ * Description: Checks of the drivers and services on the host backend
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+/* Host Test Documentation */
+/* Runs the drivers and the services on the simulated registers of the host backend and checks
+ * their behavior in virtual time : each test starts from Host_Reset() with the clock tree of
+ * src/main.c (84 MHz) and the GPT monotonic clock started.
+ *   sh Host/build.sh        builds _host/host_test
+ *   ./_host/host_test       runs all the tests, the exit status is 0 when all the checks passed
+ * A failed check prints its test, its line and its condition.
+ *  */
+
+#ifdef HOST_BACKEND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Std_Types.h"
+#include "Host.h"
+#include "Rcc.h"
+#include "Rcc_Private.h"
+#include "Gpio.h"
+#include "Gpio_Private.h"
+#include "Shadow.h"
+#include "NVIC.h"
+#include "GPT.h"
+#include "GPT_Private.h"
+#include "SwTimer.h"
+#include "EventQueue.h"
+#include "Debounce.h"
+#include "Fsm.h"
+#include "Latency.h"
+#include "Inject.h"
+#include "Pwm.h"
+#include "Pattern.h"
+#include "Power.h"
+
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define TEST_NS_PER_US  1000ULL
+#define TEST_NS_PER_MS  1000000ULL
+
+/* Check a condition of the running test */
+#define TEST_CHECK(CONDITION)  Test_Check(((CONDITION) ? TRUE : FALSE), #CONDITION, __LINE__)
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* Clock tree of src/main.c : HSI 16 MHz / 16 x 336 / 4 = 84 MHz core, APB1 timers 84 MHz */
+static const Rcc_ClockConfigType test_clock_config = {
+	.SysclkSource = RCC_SYSCLK_PLL,
+	.PllSource = RCC_PLL_SRC_HSI,
+	.PllM = 16,
+	.PllN = 336,
+	.PllP = 4,
+	.PllQ = 7,
+	.AhbDivider = 1,
+	.Apb1Divider = 2,
+	.Apb2Divider = 1,
+};
+
+static const char * test_name;
+static uint32 test_checks;
+static uint32 test_failures;
+
+/* Calls recorded by the callbacks of the tests */
+static uint32 test_calls;
+static uint8 test_order[8];
+static uint8 test_level;
+
+/* Clock read by the interrupt of higher priority of the clock wrap test */
+static uint64 test_last_ticks;
+static boolean test_monotonic;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+static void Test_Check(boolean Passed, const char * Condition, int Line)
+{
+	test_checks++;
+	if (Passed == FALSE)
+	{
+		test_failures++;
+		printf("FAILED %s (line %d) : %s\n", test_name, Line, Condition);
+	}
+}
+
+/* Virtual time in us since Host_Reset */
+static uint64 Test_NowUs(void)
+{
+	return Host_GetTime() / TEST_NS_PER_US;
+}
+
+static void Test_AdvanceMs(uint32 Ms)
+{
+	Host_AdvanceTime((uint64)Ms * TEST_NS_PER_MS);
+}
+
+/* Start of each test : reset registers, 84 MHz clock tree, GPIO and EXTI clocks, monotonic clock */
+static void Test_Setup(void)
+{
+	Host_Reset();
+	Rcc_Init();
+	(void)Rcc_ConfigClock(&test_clock_config);
+	Rcc_Enable(RCC_SYSCFG);
+	Gpio_Init();
+	Latency_Init();
+	EventQueue_Init();
+	(void)GPT_ClockInit();
+	test_calls = 0;
+}
+
+static void Test_CountLine(uint8 LineNum)
+{
+	test_order[test_calls % 8] = LineNum;
+	test_calls++;
+}
+
+static void Test_CountCall(void)
+{
+	test_calls++;
+}
+
+static void Test_RecordTimer(uint8 TimerId)
+{
+	test_order[test_calls % 8] = TimerId;
+	test_calls++;
+}
+
+static void Test_RecordLevel(uint8 LineNum, uint8 Level)
+{
+	test_order[test_calls % 8] = LineNum;
+	test_level = Level;
+	test_calls++;
+}
+
+/*******************************************************************************
+ *                              Tests                                          *
+ *******************************************************************************/
+
+/* A pin written by the GPIO driver and an EXTI edge served by its handler */
+static void Test_GpioExti(void)
+{
+	Gpio_ConfigPin(GPIO_B, 5, GPIO_OUTPUT, GPIO_PUSH_PULL, GPIO_NO_PULL);
+	(void)Gpio_WritePinValue(GPIO_B, 5, HIGH);
+	TEST_CHECK((Host_GetPortOutput(GPIO_B) & (1U << 5)) != 0);
+	(void)Gpio_WritePinValue(GPIO_B, 5, LOW);
+	TEST_CHECK((Host_GetPortOutput(GPIO_B) & (1U << 5)) == 0);
+
+	Host_SetPinInput(GPIO_A, LINE_0, HIGH);
+	Exti_Init(PORT_A, LINE_0, FALLING_EDGE);
+	Exti_SetHandler(LINE_0, Test_CountLine);
+	Exti_Enable(LINE_0);
+	Host_SetPinInput(GPIO_A, LINE_0, LOW);
+	Test_AdvanceMs(1);
+	TEST_CHECK(test_calls == 1);
+	TEST_CHECK(test_order[0] == LINE_0);
+	/* rising edge : not selected */
+	Host_SetPinInput(GPIO_A, LINE_0, HIGH);
+	Test_AdvanceMs(1);
+	TEST_CHECK(test_calls == 1);
+	/* disabling a line of the same NVIC register leaves the others enabled */
+	Host_SetPinInput(GPIO_A, LINE_1, HIGH);
+	Exti_Init(PORT_A, LINE_1, FALLING_EDGE);
+	Exti_SetHandler(LINE_1, Test_CountLine);
+	Exti_Enable(LINE_1);
+	Exti_Disable(LINE_1);
+	Host_SetPinInput(GPIO_A, LINE_1, LOW);
+	Host_SetPinInput(GPIO_A, LINE_0, LOW);
+	Test_AdvanceMs(1);
+	TEST_CHECK(test_calls == 2);
+	TEST_CHECK(test_order[1] == LINE_0);
+	Exti_SetHandler(LINE_0, 0);
+	Exti_SetHandler(LINE_1, 0);
+}
+
+/* Port table : the fields of pins 7 and 15 (bit 31 of the registers) and the other pins kept */
+static void Test_GpioConfigPort(void)
+{
+	static const Gpio_PinConfigType table[] = {
+		{ 7,  GPIO_AF,     GPIO_PUSH_PULL, GPIO_NO_PULL, GPIO_SPEED_HIGH, GPIO_AF2 },
+		{ 15, GPIO_AF,     GPIO_PUSH_PULL, GPIO_PULL_DOWN, GPIO_SPEED_HIGH, GPIO_AF15 },
+	};
+	GpioType * regs;
+
+	Gpio_ConfigPin(GPIO_B, 0, GPIO_OUTPUT, GPIO_PUSH_PULL, GPIO_NO_PULL);
+	Gpio_ConfigPort(GPIO_B, table, sizeof(table) / sizeof(table[0]));
+	regs = GPIO_PORT_REGS(GPIO_B - GPIO_A);
+	TEST_CHECK(((regs->GPIO_AFRL >> 28) & 0x0FUL) == GPIO_AF2);
+	TEST_CHECK(((regs->GPIO_AFRH >> 28) & 0x0FUL) == GPIO_AF15);
+	TEST_CHECK(((regs->GPIO_MODER >> 30) & 0x03UL) == GPIO_AF);
+	TEST_CHECK(((regs->GPIO_MODER >> 14) & 0x03UL) == GPIO_AF);
+	TEST_CHECK(((regs->GPIO_OSPEEDR >> 30) & 0x03UL) == GPIO_SPEED_HIGH);
+	TEST_CHECK(((regs->GPIO_PUPDR >> 30) & 0x03UL) == GPIO_PULL_DOWN);
+	TEST_CHECK((regs->GPIO_MODER & 0x03UL) == GPIO_OUTPUT);
+}
+
+/* Shadow image : only the changes are written, the pins out of its mask are never written */
+static void Test_Shadow(void)
+{
+	Shadow_StatsType before;
+	Shadow_StatsType after;
+	uint8 pin;
+
+	for (pin = 0; pin <= 8; pin++)
+	{
+		Gpio_ConfigPin(GPIO_B, pin, GPIO_OUTPUT, GPIO_PUSH_PULL, GPIO_NO_PULL);
+	}
+	(void)Gpio_WritePinValue(GPIO_B, 8, HIGH);
+	Shadow_GetStats(&before);
+
+	Shadow_Init(GPIO_B, 0x000F, 0x0005);
+	TEST_CHECK((Host_GetPortOutput(GPIO_B) & 0x01FF) == 0x0105);
+	TEST_CHECK(Shadow_GetImage(GPIO_B) == 0x0005);
+	/* same level : dropped */
+	Shadow_WriteMasked(GPIO_B, 0x0001, 0);
+	/* pin 1 set and pin 0 cleared in one write */
+	Shadow_WriteMasked(GPIO_B, 0x0002, 0x0001);
+	TEST_CHECK((Host_GetPortOutput(GPIO_B) & 0x01FF) == 0x0106);
+	/* pins out of the mask : no change of the image, nothing written */
+	Shadow_WriteMasked(GPIO_B, 0x0080, 0x0100);
+	TEST_CHECK((Host_GetPortOutput(GPIO_B) & 0x01FF) == 0x0106);
+	TEST_CHECK(Shadow_GetImage(GPIO_B) == 0x0006);
+
+	Shadow_GetStats(&after);
+	TEST_CHECK((after.CommittedWrites - before.CommittedWrites) == 2);
+	TEST_CHECK((after.SuppressedWrites - before.SuppressedWrites) == 2);
+}
+
+/* Clock tree : bus frequencies of the 84 MHz tree, configurations out of the limits are refused
+ * without any change, a PLL that does not lock brings the previous clocks back */
+static void Test_RccClocks(void)
+{
+	Rcc_ClocksType clocks;
+	Rcc_ClockConfigType config = test_clock_config;
+	const Rcc_ClockConfigType hsi_config = {
+		.SysclkSource = RCC_SYSCLK_HSI,
+		.AhbDivider = 1,
+		.Apb1Divider = 2,
+		.Apb2Divider = 1,
+	};
+	uint32 cfgr;
+	uint32 pllcfgr;
+
+	Rcc_GetClocks(&clocks);
+	TEST_CHECK((clocks.Sysclk == 84000000UL) && (clocks.Hclk == 84000000UL));
+	TEST_CHECK((clocks.Pclk1 == 42000000UL) && (clocks.Apb1TimerClk == 84000000UL));
+	TEST_CHECK((clocks.Pclk2 == 84000000UL) && (clocks.Apb2TimerClk == 84000000UL));
+	TEST_CHECK((FLASH_ACR & FLASH_ACR_LATENCY_MASK) == 2);
+
+	/* out of the limits : nothing is written */
+	cfgr = RCC_CFGR;
+	pllcfgr = RCC_PLLCFGR;
+	TEST_CHECK(Rcc_ConfigClock(0) == RCC_NOK);
+	config.PllN = 100;
+	TEST_CHECK(Rcc_ConfigClock(&config) == RCC_NOK);
+	config = test_clock_config;
+	config.Apb1Divider = 1;
+	TEST_CHECK(Rcc_ConfigClock(&config) == RCC_NOK);
+	config.Apb1Divider = 3;
+	TEST_CHECK(Rcc_ConfigClock(&config) == RCC_NOK);
+	config = test_clock_config;
+	config.PllQ = 1;
+	TEST_CHECK(Rcc_ConfigClock(&config) == RCC_NOK);
+	TEST_CHECK((RCC_CFGR == cfgr) && (RCC_PLLCFGR == pllcfgr));
+
+	/* HSI core, then the PLL does not lock : back on HSI with its dividers, PLL off and unchanged */
+	TEST_CHECK(Rcc_ConfigClock(&hsi_config) == RCC_OK);
+	Rcc_GetClocks(&clocks);
+	TEST_CHECK((clocks.Sysclk == 16000000UL) && (clocks.Pclk1 == 8000000UL) && (clocks.Apb1TimerClk == 16000000UL));
+	TEST_CHECK(READ_BIT(RCC_CR, RCC_CR_PLLON) == 0);
+	cfgr = RCC_CFGR;
+	pllcfgr = RCC_PLLCFGR;
+	Host_SetPllLock(FALSE);
+	config = test_clock_config;
+	config.PllN = 256;
+	TEST_CHECK(Rcc_ConfigClock(&config) == RCC_NOK);
+	TEST_CHECK((RCC_CFGR == cfgr) && (RCC_PLLCFGR == pllcfgr));
+	TEST_CHECK(READ_BIT(RCC_CR, RCC_CR_PLLON) == 0);
+	TEST_CHECK((FLASH_ACR & FLASH_ACR_LATENCY_MASK) == 0);
+
+	/* PLL core and the PLL does not lock any more : left on HSI, the last configuration comes back
+	 * with Rcc_RestoreClock once the PLL locks */
+	Host_SetPllLock(TRUE);
+	TEST_CHECK(Rcc_ConfigClock(&test_clock_config) == RCC_OK);
+	Host_SetPllLock(FALSE);
+	TEST_CHECK(Rcc_ConfigClock(&config) == RCC_NOK);
+	Rcc_GetClocks(&clocks);
+	TEST_CHECK((clocks.Sysclk == 16000000UL) && (clocks.Pclk1 == 8000000UL));
+	Host_SetPllLock(TRUE);
+	Rcc_RestoreClock();
+	Rcc_GetClocks(&clocks);
+	TEST_CHECK((clocks.Sysclk == 84000000UL) && (clocks.Pclk1 == 42000000UL));
+}
+
+/* One pulse countdown of a GPT timer : running before its time, expired after it */
+static void Test_GptCountdown(void)
+{
+	GPT_SnapshotType snapshot;
+
+	TEST_CHECK(GPT_Init(GPT_TIM3) == GPT_OK);
+	GPT_SetCallback(GPT_TIM3, Test_CountCall);
+	GPT_StartTimer(GPT_TIM3, 10);
+	Host_AdvanceTime(9500ULL * TEST_NS_PER_US);
+	GPT_Snapshot(GPT_TIM3, &snapshot);
+	TEST_CHECK(snapshot.Status == NO_OVERFLOW);
+	TEST_CHECK(snapshot.Elapsed == 9);
+	TEST_CHECK(snapshot.Remaining == 1);
+	TEST_CHECK(test_calls == 0);
+	Test_AdvanceMs(1);
+	TEST_CHECK(test_calls == 1);
+	TEST_CHECK(GPT_CheckTimeIsElapsed(GPT_TIM3) == OVERFLOW);
+	TEST_CHECK(GPT_CheckTimeIsElapsed(GPT_TIM3) == TIMER_NOT_STARTED);
+	GPT_Release(GPT_TIM3);
+}
+
+/* 0 ms expires at once through the interrupt, longer requests than the counter are clamped */
+static void Test_GptLimits(void)
+{
+	GPT_SnapshotType snapshot;
+
+	TEST_CHECK(GPT_Init(GPT_TIM3) == GPT_OK);
+	GPT_SetCallback(GPT_TIM3, Test_CountCall);
+	GPT_StartTimer(GPT_TIM3, 0);
+	Host_AdvanceCycles(100);
+	TEST_CHECK(test_calls == 1);
+	TEST_CHECK(GPT_CheckTimeIsElapsed(GPT_TIM3) == OVERFLOW);
+	/* 429496730 ms * 10 ticks wraps to 4 ticks in 32 bits : clamped to the 16-bit counter */
+	GPT_StartTimer(GPT_TIM3, 429496730UL);
+	Test_AdvanceMs(1);
+	GPT_Snapshot(GPT_TIM3, &snapshot);
+	TEST_CHECK(snapshot.Status == NO_OVERFLOW);
+	TEST_CHECK(snapshot.Remaining == 6553);
+	Test_AdvanceMs(6553);
+	TEST_CHECK(test_calls == 2);
+	TEST_CHECK(GPT_CheckTimeIsElapsed(GPT_TIM3) == OVERFLOW);
+	GPT_Release(GPT_TIM3);
+}
+
+/* Probes : a measure from its start to its stop, a stop without start ignored, the timer
+ * interrupt measured by the probe given to GPT_SetProbe */
+static void Test_Latency(void)
+{
+	Latency_StatsType stats;
+
+	Latency_Start(0);
+	Host_AdvanceCycles(8400);
+	Latency_Stop(0);
+	Latency_Stop(0);
+	TEST_CHECK(Latency_GetStats(0, &stats) == TRUE);
+	TEST_CHECK(stats.Count == 1);
+	TEST_CHECK((stats.Last >= 8400) && (stats.Last < 8500));
+	TEST_CHECK(stats.Histogram[13] == 1);
+
+	TEST_CHECK(GPT_Init(GPT_TIM3) == GPT_OK);
+	GPT_SetCallback(GPT_TIM3, Test_CountCall);
+	GPT_SetProbe(GPT_TIM3, 1);
+	GPT_StartTimer(GPT_TIM3, 1);
+	Test_AdvanceMs(2);
+	TEST_CHECK(test_calls == 1);
+	TEST_CHECK(Latency_GetStats(1, &stats) == TRUE);
+	TEST_CHECK(stats.Count == 1);
+
+	/* a caller with the interrupts masked keeps them masked : the expiry waits for its unmask */
+	Host_SetPrimask(TRUE);
+	GPT_StartTimer(GPT_TIM3, 1);
+	Test_AdvanceMs(2);
+	TEST_CHECK(Latency_GetStats(1, &stats) == TRUE);
+	Latency_Clear(0);
+	Test_AdvanceMs(1);
+	TEST_CHECK(test_calls == 1);
+	Host_SetPrimask(FALSE);
+	TEST_CHECK(test_calls == 2);
+	TEST_CHECK((Latency_GetStats(0, &stats) == TRUE) && (stats.Count == 0));
+	GPT_SetProbe(GPT_TIM3, GPT_NO_PROBE);
+	GPT_Release(GPT_TIM3);
+	TEST_CHECK(Latency_GetStats(LATENCY_NUM_OF_PROBES, &stats) == FALSE);
+}
+
+/* Snapshots around an expiry held off by PRIMASK, one per core cycle : the counter is either
+ * counting at the end of its 10 ms or expired, never restarted from 0 while still counting */
+static void Test_GptSnapshotRace(void)
+{
+	GPT_SnapshotType snapshot;
+	uint32 offset;
+	boolean coherent = TRUE;
+	boolean overflowSeen = FALSE;
+
+	TEST_CHECK(GPT_Init(GPT_TIM3) == GPT_OK);
+	for (offset = 0; offset < 200; offset++)
+	{
+		Host_SetPrimask(TRUE);
+		GPT_StartTimer(GPT_TIM3, 10);
+		/* 10 ms at 84 MHz, the snapshot is taken from 100 cycles before the expiry, the interrupt
+		 * is held off so the expiry is only seen in the registers */
+		Host_AdvanceCycles(840000ULL - 100ULL + offset);
+		GPT_Snapshot(GPT_TIM3, &snapshot);
+		if (snapshot.Status == OVERFLOW)
+		{
+			overflowSeen = TRUE;
+			coherent = coherent && (snapshot.Elapsed == 10) && (snapshot.Remaining == 0);
+		}
+		else
+		{
+			coherent = coherent && (snapshot.Status == NO_OVERFLOW) && (snapshot.Elapsed == 9) &&
+			           (snapshot.Remaining == 1);
+		}
+		Host_SetPrimask(FALSE);
+		GPT_EndTimer(GPT_TIM3);
+	}
+	TEST_CHECK(coherent == TRUE);
+	TEST_CHECK(overflowSeen == TRUE);
+	GPT_Release(GPT_TIM3);
+}
+
+/* The monotonic clock counts the virtual time in us */
+static void Test_GptClock(void)
+{
+	uint64 start = GPT_GetTicks64();
+	uint64 startUs = Test_NowUs();
+
+	Test_AdvanceMs(1500);
+	TEST_CHECK((GPT_GetTicks64() - start) >= 1499000ULL);
+	TEST_CHECK((GPT_GetTicks64() - start) <= (Test_NowUs() - startUs) + 1);
+	TEST_CHECK(GPT_GetTimeMs64() >= 1500);
+}
+
+static void Test_ReadClock(void)
+{
+	uint64 ticks = GPT_GetTicks64();
+
+	if (ticks < test_last_ticks)
+	{
+		test_monotonic = FALSE;
+	}
+	test_last_ticks = ticks;
+	test_calls++;
+}
+
+/* Wrap of the 32-bit counter : the clock read by an interrupt of higher priority than TIM5
+ * and by the thread never goes back and reaches the high 32 bits */
+static void Test_GptClockWrap(void)
+{
+	uint32 ms;
+
+	Nvic_SetPriorityGrouping(NVIC_GROUP_4_0);
+	Nvic_SetPriority(TIM5_IRQ_POSITION, 2, 0);
+	Nvic_SetPriority(TIM3_IRQ_POSITION, 1, 0);
+	TIM5->CNT = 0xFFFFFFFFUL - 3000UL;
+	test_last_ticks = GPT_GetTicks64();
+	test_monotonic = TRUE;
+
+	TEST_CHECK(GPT_Init(GPT_TIM3) == GPT_OK);
+	GPT_SetCallback(GPT_TIM3, Test_ReadClock);
+	for (ms = 0; ms < 6; ms++)
+	{
+		GPT_StartTimer(GPT_TIM3, 1);
+		Host_AdvanceTime(1000ULL * TEST_NS_PER_US);
+		Test_ReadClock();
+	}
+	TEST_CHECK(test_calls >= 11);
+	TEST_CHECK(test_monotonic == TRUE);
+	TEST_CHECK(test_last_ticks >= 0x100000000ULL);
+	TEST_CHECK(test_last_ticks < 0x100000000ULL + 4000ULL);
+	GPT_Release(GPT_TIM3);
+}
+
+/* Events queue : order, full queue and overflow count */
+static void Test_EventQueue(void)
+{
+	EventQueue_EventType event;
+	uint32 index;
+	boolean ordered = TRUE;
+
+	event.Type = EVENTQUEUE_TIMER;
+	event.Level = 0;
+	for (index = 0; index < EVENTQUEUE_SIZE; index++)
+	{
+		event.Id = (uint8)index;
+		event.Timestamp = index;
+		TEST_CHECK(EventQueue_Post(&event) == EVENTQUEUE_OK);
+	}
+	TEST_CHECK(EventQueue_Post(&event) == EVENTQUEUE_FULL);
+	TEST_CHECK(EventQueue_GetOverflowCount() == 1);
+	for (index = 0; index < EVENTQUEUE_SIZE; index++)
+	{
+		if ((EventQueue_Get(&event) == FALSE) || (event.Id != (uint8)index))
+		{
+			ordered = FALSE;
+		}
+	}
+	TEST_CHECK(ordered == TRUE);
+	TEST_CHECK(EventQueue_IsEmpty() == TRUE);
+	TEST_CHECK(EventQueue_Get(&event) == FALSE);
+}
+
+/* Handler of the injected EXTI edges : one event per edge, as a button */
+static void Test_PostLine(uint8 LineNum)
+{
+	EventQueue_EventType event;
+
+	event.Timestamp = (uint32)GPT_GetTicks64();
+	event.Type = EVENTQUEUE_BUTTON;
+	event.Id = LineNum;
+	event.Level = 0;
+	(void)EventQueue_Post(&event);
+}
+
+/* Events received by the main loop till the script ends, the queue drained every DrainMs
+ * (0 : only at the end) */
+static uint32 Test_RunScript(const Inject_StepType * Script, uint8 NumOfSteps, uint32 DrainMs)
+{
+	EventQueue_EventType event;
+	uint32 received = 0;
+	uint32 elapsed = 0;
+
+	Inject_Run(Script, NumOfSteps);
+	while (Inject_IsRunning() == TRUE)
+	{
+		Test_AdvanceMs(1);
+		elapsed++;
+		if ((DrainMs != 0) && ((elapsed % DrainMs) == 0))
+		{
+			while (EventQueue_Get(&event) == TRUE)
+			{
+				received++;
+			}
+		}
+	}
+	Test_AdvanceMs(1);
+	while (EventQueue_Get(&event) == TRUE)
+	{
+		received++;
+	}
+	return received;
+}
+
+/* Bursts of software edges : all handled when the loop keeps up, the queue overflow counted when it does not */
+static void Test_InjectBurst(void)
+{
+	static const Inject_StepType paced[] = {
+		{ INJECT_EXTI, LINE_1, 1000, 200 },
+	};
+	static const Inject_StepType burst[] = {
+		{ INJECT_WAIT, 0, 1, 1000 },
+		{ INJECT_EXTI, LINE_1, 200, 10 },
+	};
+
+	TEST_CHECK(Inject_Init() == INJECT_OK);
+	Exti_Init(PORT_A, LINE_1, FALLING_EDGE);
+	Exti_SetHandler(LINE_1, Test_PostLine);
+	Exti_Enable(LINE_1);
+
+	/* 1000 edges at 200 us, the loop drains the queue every ms */
+	TEST_CHECK(Test_RunScript(paced, 1, 1) == 1000);
+	TEST_CHECK(Inject_GetFiredCount() == 1000);
+	TEST_CHECK(EventQueue_GetOverflowCount() == 0);
+
+	/* 200 edges at 10 us while the loop is busy : the queue keeps EVENTQUEUE_SIZE of them */
+	TEST_CHECK(Test_RunScript(burst, 2, 0) == EVENTQUEUE_SIZE);
+	TEST_CHECK(Inject_GetFiredCount() == 200);
+	TEST_CHECK(EventQueue_GetOverflowCount() == (200 - EVENTQUEUE_SIZE));
+
+	Exti_Disable(LINE_1);
+	Exti_SetHandler(LINE_1, 0);
+	GPT_Release(INJECT_TIMER);
+}
+
+/* Software timers : expiries in deadline order, periodic timer, stop */
+/* Accesses of the tests to one register block */
+static uint8 test_block;
+static uint32 test_block_accesses;
+
+static void Test_CountBlock(uint8 Block)
+{
+	if (Block == test_block)
+	{
+		test_block_accesses++;
+	}
+}
+
+static void Test_SwTimer(void)
+{
+	SwTimer_Init();
+	SwTimer_Start(0, 30, 0, Test_RecordTimer);
+	SwTimer_Start(1, 10, 0, Test_RecordTimer);
+	SwTimer_Start(2, 20, 0, Test_RecordTimer);
+	TEST_CHECK(SwTimer_GetRunningCount() == 3);
+	Test_AdvanceMs(9);
+	TEST_CHECK(test_calls == 0);
+	Test_AdvanceMs(25);
+	TEST_CHECK(test_calls == 3);
+	TEST_CHECK((test_order[0] == 1) && (test_order[1] == 2) && (test_order[2] == 0));
+	TEST_CHECK(SwTimer_CheckExpired(1) == TRUE);
+	TEST_CHECK(SwTimer_CheckExpired(1) == FALSE);
+	TEST_CHECK(SwTimer_GetRunningCount() == 0);
+
+	/* polling the flags leaves the alarm (TIM5) alone, the pending timer expires on time */
+	test_calls = 0;
+	SwTimer_Start(4, 10, 0, Test_RecordTimer);
+	test_block = HOST_TIM5;
+	test_block_accesses = 0;
+	Host_SetAccessHook(Test_CountBlock);
+	TEST_CHECK(SwTimer_CheckExpired(4) == FALSE);
+	TEST_CHECK(SwTimer_CheckExpired(0) == TRUE);
+	Host_SetAccessHook(0);
+	TEST_CHECK(test_block_accesses == 0);
+	Test_AdvanceMs(11);
+	TEST_CHECK(test_calls == 1);
+	TEST_CHECK(SwTimer_CheckExpired(4) == TRUE);
+
+	/* periodic : 5 ms then every 5 ms, stopped after 4 expiries */
+	test_calls = 0;
+	SwTimer_Start(3, 5, 5, Test_RecordTimer);
+	Host_AdvanceTime(22ULL * TEST_NS_PER_MS);
+	TEST_CHECK(test_calls == 4);
+	SwTimer_Stop(3);
+	Test_AdvanceMs(20);
+	TEST_CHECK(test_calls == 4);
+	TEST_CHECK(SwTimer_IsRunning(3) == FALSE);
+}
+
+/* Debounce : the chatter is dropped, the level is confirmed after the quiet window */
+static void Test_Debounce(void)
+{
+	Host_SetPinInput(GPIO_A, LINE_2, HIGH);
+	Exti_Init(PORT_A, LINE_2, RISING_FALLING_EDGE);
+	TEST_CHECK(Debounce_Init() == DEBOUNCE_OK);
+	Debounce_ConfigLine(PORT_A, LINE_2, 20, Test_RecordLevel);
+	Exti_SetHandler(LINE_2, Debounce_OnEdge);
+	Exti_Enable(LINE_2);
+	TEST_CHECK(Debounce_GetLevel(LINE_2) == HIGH);
+
+	/* press with bounces at 0, 2 and 4 ms : confirmed 20 ms after the last edge */
+	Host_SetPinInput(GPIO_A, LINE_2, LOW);
+	Test_AdvanceMs(2);
+	Host_SetPinInput(GPIO_A, LINE_2, HIGH);
+	Test_AdvanceMs(2);
+	Host_SetPinInput(GPIO_A, LINE_2, LOW);
+	Test_AdvanceMs(19);
+	TEST_CHECK(test_calls == 0);
+	TEST_CHECK(Debounce_IsBusy() == TRUE);
+	Test_AdvanceMs(2);
+	TEST_CHECK(test_calls == 1);
+	TEST_CHECK((test_order[0] == LINE_2) && (test_level == LOW));
+	TEST_CHECK(Debounce_GetLevel(LINE_2) == LOW);
+	TEST_CHECK(Debounce_IsBusy() == FALSE);
+
+	/* glitch shorter than the window, back to the confirmed level : no report */
+	Host_SetPinInput(GPIO_A, LINE_2, HIGH);
+	Test_AdvanceMs(5);
+	Host_SetPinInput(GPIO_A, LINE_2, LOW);
+	Test_AdvanceMs(30);
+	TEST_CHECK(test_calls == 1);
+	Exti_SetHandler(LINE_2, 0);
+	GPT_Release(DEBOUNCE_TIMER);
+}
+
+/* State machine : guards, transition action, entry / exit, completion and internal transitions */
+#define TEST_IDLE      0
+#define TEST_ARMED     1
+#define TEST_RUNNING   2
+#define TEST_EV_GO     0
+#define TEST_EV_TICK   1
+
+static boolean test_ready;
+static uint32 test_entries;
+static uint32 test_exits;
+static uint32 test_actions;
+
+static boolean Test_IsReady(void)  { return test_ready; }
+static void Test_Entry(void)       { test_entries++; }
+static void Test_Exit(void)        { test_exits++; }
+static void Test_Action(void)      { test_actions++; }
+
+static const Fsm_StateType test_states[] = {
+	{ Test_Entry, Test_Exit, 0 },
+	{ Test_Entry, Test_Exit, 0 },
+	{ Test_Entry, Test_Exit, 0 },
+};
+
+static const Fsm_TransitionType test_transitions[] = {
+	{ TEST_IDLE,    TEST_EV_GO,     Test_IsReady, Test_Action, TEST_ARMED },
+	{ TEST_ARMED,   FSM_COMPLETION, 0,            0,           TEST_RUNNING },
+	{ TEST_RUNNING, TEST_EV_TICK,   0,            Test_Action, FSM_INTERNAL },
+	{ TEST_RUNNING, TEST_EV_GO,     0,            0,           TEST_IDLE },
+};
+
+static void Test_Fsm(void)
+{
+	Fsm_MachineType machine = {
+		.States = test_states,
+		.NumOfStates = sizeof(test_states) / sizeof(test_states[0]),
+		.Transitions = test_transitions,
+		.NumOfTransitions = sizeof(test_transitions) / sizeof(test_transitions[0]),
+		.Current = TEST_IDLE,
+	};
+
+	test_ready = FALSE;
+	test_entries = 0;
+	test_exits = 0;
+	test_actions = 0;
+	Fsm_Start(&machine, TEST_IDLE);
+	TEST_CHECK(test_entries == 1);
+
+	/* guard FALSE : no transition */
+	TEST_CHECK(Fsm_Dispatch(&machine, TEST_EV_GO) == FALSE);
+	TEST_CHECK(Fsm_GetState(&machine) == TEST_IDLE);
+
+	/* IDLE -> ARMED, then the completion ARMED -> RUNNING in the same dispatch */
+	test_ready = TRUE;
+	TEST_CHECK(Fsm_Dispatch(&machine, TEST_EV_GO) == TRUE);
+	TEST_CHECK(Fsm_GetState(&machine) == TEST_RUNNING);
+	TEST_CHECK((test_entries == 3) && (test_exits == 2) && (test_actions == 1));
+
+	/* internal transition : action only */
+	TEST_CHECK(Fsm_Dispatch(&machine, TEST_EV_TICK) == TRUE);
+	TEST_CHECK(Fsm_GetState(&machine) == TEST_RUNNING);
+	TEST_CHECK((test_entries == 3) && (test_exits == 2) && (test_actions == 2));
+
+	TEST_CHECK(Fsm_Dispatch(&machine, TEST_EV_GO) == TRUE);
+	TEST_CHECK(Fsm_GetState(&machine) == TEST_IDLE);
+}
+
+/* Pwm fade : linear ramp of one step per PWM period, it lands on the target at the end of the duration */
+static void Test_PwmFade(void)
+{
+	TimxType * timer = GPT_GetRegisters(GPT_TIM4);
+	uint16 duty;
+
+	Pwm_Init(PWM_TIM4);
+	Pwm_ConfigChannel(PWM_TIM4, PWM_CHANNEL_2);
+	TEST_CHECK(Pwm_GetDuty(PWM_TIM4, PWM_CHANNEL_2) == PWM_DUTY_OFF);
+
+	/* fade in over 100 ms : half way at 50 ms, rising, target reached at 100 ms */
+	Pwm_StartFade(PWM_TIM4, PWM_CHANNEL_2, PWM_DUTY_MAX, 100);
+	TEST_CHECK(Pwm_IsFading(PWM_TIM4, PWM_CHANNEL_2) == TRUE);
+	Test_AdvanceMs(50);
+	duty = Pwm_GetDuty(PWM_TIM4, PWM_CHANNEL_2);
+	TEST_CHECK((duty > 450) && (duty < 550));
+	TEST_CHECK(timer->CCR2 == duty);
+	Test_AdvanceMs(10);
+	TEST_CHECK(Pwm_GetDuty(PWM_TIM4, PWM_CHANNEL_2) > duty);
+	TEST_CHECK(Pwm_IsFading(PWM_TIM4, PWM_CHANNEL_2) == TRUE);
+	Test_AdvanceMs(42);
+	TEST_CHECK(Pwm_IsFading(PWM_TIM4, PWM_CHANNEL_2) == FALSE);
+	TEST_CHECK(Pwm_GetDuty(PWM_TIM4, PWM_CHANNEL_2) == PWM_DUTY_MAX);
+	TEST_CHECK(timer->CCR2 == PWM_DUTY_MAX);
+
+	/* same target again : nothing to do */
+	Pwm_StartFade(PWM_TIM4, PWM_CHANNEL_2, PWM_DUTY_MAX, 100);
+	TEST_CHECK(Pwm_IsFading(PWM_TIM4, PWM_CHANNEL_2) == FALSE);
+
+	/* fade out over 30 ms, lands exactly on 0 and stays there */
+	Pwm_StartFade(PWM_TIM4, PWM_CHANNEL_2, PWM_DUTY_OFF, 30);
+	Test_AdvanceMs(15);
+	duty = Pwm_GetDuty(PWM_TIM4, PWM_CHANNEL_2);
+	TEST_CHECK((duty > PWM_DUTY_OFF) && (duty < PWM_DUTY_MAX));
+	Test_AdvanceMs(17);
+	TEST_CHECK(Pwm_IsFading(PWM_TIM4, PWM_CHANNEL_2) == FALSE);
+	TEST_CHECK(Pwm_GetDuty(PWM_TIM4, PWM_CHANNEL_2) == PWM_DUTY_OFF);
+	TEST_CHECK(timer->CCR2 == PWM_DUTY_OFF);
+	Test_AdvanceMs(10);
+	TEST_CHECK(timer->CCR2 == PWM_DUTY_OFF);
+	GPT_Release(GPT_TIM4);
+}
+
+/* Pwm blink : edges of the toggle on match output of TIM4 channel 1 on PB6 */
+#define TEST_BLINK_PIN      6
+#define TEST_MAX_EDGES      16
+
+static uint64 test_edge_us[TEST_MAX_EDGES];
+static uint8 test_edge_level[TEST_MAX_EDGES];
+static uint32 test_edges;
+
+static void Test_RecordEdge(uint8 PortName, uint16 OldOutput, uint16 NewOutput)
+{
+	if ((PortName == GPIO_B) && (((OldOutput ^ NewOutput) & (1U << TEST_BLINK_PIN)) != 0))
+	{
+		if (test_edges < TEST_MAX_EDGES)
+		{
+			test_edge_us[test_edges] = Test_NowUs();
+			test_edge_level[test_edges] = (uint8)((NewOutput >> TEST_BLINK_PIN) & 1U);
+		}
+		test_edges++;
+	}
+}
+
+static boolean Test_PinIsHigh(void)
+{
+	return ((Host_GetPortOutput(GPIO_B) & (1U << TEST_BLINK_PIN)) != 0) ? TRUE : FALSE;
+}
+
+static void Test_PwmBlink(void)
+{
+	static const Gpio_PinConfigType pin[] = {
+		{ TEST_BLINK_PIN, GPIO_AF, GPIO_PUSH_PULL, GPIO_NO_PULL, GPIO_SPEED_LOW, GPIO_AF2 },
+	};
+	uint64 start;
+	uint32 index;
+
+	Gpio_ConfigPort(GPIO_B, pin, sizeof(pin) / sizeof(pin[0]));
+	Pwm_Init(PWM_TIM4);
+	Pwm_ConfigChannel(PWM_TIM4, PWM_CHANNEL_1);
+	test_edges = 0;
+	Host_SetOutputHook(Test_RecordEdge);
+
+	/* 3 blinks of 20 ms on, 30 ms off : 6 edges, first one within 2 PWM periods */
+	start = Test_NowUs();
+	Pwm_StartBlink(PWM_TIM4, PWM_CHANNEL_1, 20, 30, 3);
+	TEST_CHECK(Pwm_IsBlinking(PWM_TIM4, PWM_CHANNEL_1) == TRUE);
+	Test_AdvanceMs(200);
+	TEST_CHECK(test_edges == 6);
+	TEST_CHECK((test_edge_us[0] - start) <= (2 * PWM_PERIOD_MS * 1000));
+	for (index = 0; index < 6; index++)
+	{
+		TEST_CHECK(test_edge_level[index] == (((index % 2) == 0) ? 1 : 0));
+	}
+	for (index = 1; index < 6; index++)
+	{
+		TEST_CHECK((test_edge_us[index] - test_edge_us[index - 1]) == (((index % 2) == 1) ? 20000 : 30000));
+	}
+	TEST_CHECK(Pwm_IsBlinking(PWM_TIM4, PWM_CHANNEL_1) == FALSE);
+	TEST_CHECK(Test_PinIsHigh() == FALSE);
+
+	/* restart in the middle of an on time : low at once, then the new blinks only */
+	Pwm_StartBlink(PWM_TIM4, PWM_CHANNEL_1, 50, 50, 5);
+	Test_AdvanceMs(20);
+	TEST_CHECK(Test_PinIsHigh() == TRUE);
+	test_edges = 0;
+	Pwm_StartBlink(PWM_TIM4, PWM_CHANNEL_1, 10, 10, 2);
+	Test_AdvanceMs(1);
+	TEST_CHECK(Test_PinIsHigh() == FALSE);
+	Test_AdvanceMs(100);
+	TEST_CHECK(test_edges == 5);
+	TEST_CHECK((test_edge_level[0] == 0) && (test_edge_level[1] == 1) && (test_edge_level[4] == 0));
+	TEST_CHECK((test_edge_us[2] - test_edge_us[1]) == 10000);
+	TEST_CHECK(Test_PinIsHigh() == FALSE);
+
+	/* stop in an on time : the falling edge only */
+	Pwm_StartBlink(PWM_TIM4, PWM_CHANNEL_1, 10, 10, 100);
+	Test_AdvanceMs(5);
+	TEST_CHECK(Test_PinIsHigh() == TRUE);
+	test_edges = 0;
+	Pwm_StopBlink(PWM_TIM4, PWM_CHANNEL_1);
+	Test_AdvanceMs(50);
+	TEST_CHECK(Pwm_IsBlinking(PWM_TIM4, PWM_CHANNEL_1) == FALSE);
+	TEST_CHECK(Test_PinIsHigh() == FALSE);
+	TEST_CHECK((test_edges == 1) && (test_edge_level[0] == 0));
+	Host_SetOutputHook(0);
+	GPT_Release(GPT_TIM4);
+}
+
+/* Pattern : two slots step on their own timers, a step of 0 ms ends the pattern */
+static const Pattern_StepType test_slow_steps[] = {
+	{ 0x01, 0x01, 10 },
+	{ 0x01, 0x00, 20 },
+	{ 0x01, 0x01, 0 },
+};
+static const Pattern_StepType test_fast_steps[] = {
+	{ 0x02, 0x02, 5 },
+	{ 0x02, 0x00, 5 },
+	{ 0x02, 0x02, 5 },
+	{ 0x02, 0x00, 0 },
+};
+static const Pattern_Type test_slow = { test_slow_steps, sizeof(test_slow_steps) / sizeof(test_slow_steps[0]) };
+static const Pattern_Type test_fast = { test_fast_steps, sizeof(test_fast_steps) / sizeof(test_fast_steps[0]) };
+
+static uint16 test_leds;
+static uint32 test_expired;      /* timers expired, not yet given to Pattern_Step */
+
+static void Test_PatternOutput(uint16 Mask, uint16 Level)
+{
+	test_leds = (uint16)((test_leds & ~Mask) | (Level & Mask));
+	test_calls++;
+}
+
+static void Test_PatternExpired(uint8 TimerId)
+{
+	test_expired |= (1UL << TimerId);
+}
+
+/* Main loop of the sequencer : the expiries are given to Pattern_Step every 100 us */
+static void Test_PatternRun(uint32 Ms)
+{
+	uint32 step;
+	uint8 timerId;
+
+	for (step = 0; step < (Ms * 10); step++)
+	{
+		Host_AdvanceTime(100ULL * TEST_NS_PER_US);
+		for (timerId = 0; timerId < SWTIMER_MAX_TIMERS; timerId++)
+		{
+			if ((test_expired & (1UL << timerId)) != 0)
+			{
+				test_expired &= ~(1UL << timerId);
+				TEST_CHECK(Pattern_Step(timerId) == TRUE);
+			}
+		}
+	}
+}
+
+static void Test_Pattern(void)
+{
+	SwTimer_Init();
+	Pattern_Init(Test_PatternOutput, Test_PatternExpired);
+	test_leds = 0;
+	test_expired = 0;
+
+	/* first steps output at once */
+	Pattern_Start(0, &test_slow);
+	Pattern_Start(1, &test_fast);
+	TEST_CHECK((test_leds == 0x03) && (test_calls == 2));
+	TEST_CHECK((Pattern_IsRunning(0) == TRUE) && (Pattern_IsRunning(1) == TRUE));
+
+	Test_PatternRun(7);
+	TEST_CHECK(test_leds == 0x01);
+	Test_PatternRun(5);
+	TEST_CHECK(test_leds == 0x02);
+	/* fast pattern ended on its last step, the slow one goes on */
+	Test_PatternRun(8);
+	TEST_CHECK(test_leds == 0x00);
+	TEST_CHECK((Pattern_IsRunning(0) == TRUE) && (Pattern_IsRunning(1) == FALSE));
+	Test_PatternRun(15);
+	TEST_CHECK(test_leds == 0x01);
+	TEST_CHECK(Pattern_IsRunning(0) == FALSE);
+	TEST_CHECK(test_calls == 7);
+	TEST_CHECK(SwTimer_GetRunningCount() == 0);
+
+	/* the levels of the last steps stay, nothing more is output */
+	Test_PatternRun(50);
+	TEST_CHECK((test_leds == 0x01) && (test_calls == 7));
+	/* a timer out of the slots is not taken */
+	TEST_CHECK(Pattern_Step(0) == FALSE);
+
+	/* stopped pattern : the LEDs keep their levels */
+	Pattern_Start(1, &test_fast);
+	Test_PatternRun(2);
+	Pattern_Stop(1);
+	Test_PatternRun(20);
+	TEST_CHECK((test_leds == 0x03) && (test_calls == 8));
+	TEST_CHECK(Pattern_IsRunning(1) == FALSE);
+}
+
+/* Power : the Stop periods (GPT clock frozen) are timed by the RTC, idle + busy is the wall time */
+static uint64 test_press_ns;
+
+/* Button pressed while the core sleeps, at test_press_ns */
+static void Test_PressInIdle(uint8 Block)
+{
+	if ((Block == HOST_IDLE) && (Host_GetTime() >= test_press_ns))
+	{
+		Host_SetAccessHook(0);
+		Host_SetPinInput(GPIO_A, LINE_2, LOW);
+	}
+}
+
+static void Test_PowerStop(void)
+{
+	Power_StatsType stats;
+	uint64 start;
+	uint64 stop;
+
+	Host_SetPinInput(GPIO_A, LINE_2, HIGH);
+	Exti_Init(PORT_A, LINE_2, FALLING_EDGE);
+	Exti_SetHandler(LINE_2, Test_CountLine);
+	Exti_Enable(LINE_2);
+	Power_Init();
+	Power_ClearStats();
+	start = Test_NowUs();
+
+	/* Stop for 500 ms till the button : the GPT clock does not move, the RTC times it (4 ms) */
+	test_press_ns = Host_GetTime() + (500ULL * TEST_NS_PER_MS);
+	Host_SetWakeupTime(test_press_ns);
+	Host_SetAccessHook(Test_PressInIdle);
+	Power_Idle(POWER_STOP);
+	TEST_CHECK(test_calls == 1);
+	Power_GetStats(&stats);
+	TEST_CHECK(stats.Stops == 1);
+	TEST_CHECK((stats.StopTicks >= 496000) && (stats.StopTicks <= 504000));
+	TEST_CHECK(stats.IdleTicks == stats.StopTicks);
+	stop = stats.StopTicks;
+
+	/* Sleep for a 20 ms countdown : timed by the GPT clock, the Stop time is kept */
+	TEST_CHECK(GPT_Init(GPT_TIM3) == GPT_OK);
+	GPT_StartTimer(GPT_TIM3, 20);
+	Power_Idle(POWER_SLEEP);
+	Power_GetStats(&stats);
+	TEST_CHECK((stats.Sleeps == 1) && (stats.StopTicks == stop));
+	TEST_CHECK((stats.IdleTicks - stop) >= 19000);
+	TEST_CHECK(((stats.IdleTicks + stats.BusyTicks + 4000) >= (Test_NowUs() - start)) &&
+	           ((stats.IdleTicks + stats.BusyTicks) <= (Test_NowUs() - start + 4000)));
+
+	Power_ClearStats();
+	Power_GetStats(&stats);
+	TEST_CHECK((stats.IdleTicks == 0) && (stats.StopTicks == 0) && (stats.Stops == 0));
+	Exti_SetHandler(LINE_2, 0);
+	GPT_Release(GPT_TIM3);
+}
+
+/*******************************************************************************
+ *                                Main                                         *
+ *******************************************************************************/
+
+typedef struct {
+	const char * Name;
+	void (*Run)(void);
+} Test_Type;
+
+static const Test_Type test_list[] = {
+	{ "rcc_clocks",    Test_RccClocks },
+	{ "gpio_exti",     Test_GpioExti },
+	{ "gpio_config",   Test_GpioConfigPort },
+	{ "shadow",        Test_Shadow },
+	{ "gpt_countdown", Test_GptCountdown },
+	{ "gpt_limits",    Test_GptLimits },
+	{ "gpt_snapshot",  Test_GptSnapshotRace },
+	{ "latency",       Test_Latency },
+	{ "gpt_clock",     Test_GptClock },
+	{ "gpt_clock_wrap", Test_GptClockWrap },
+	{ "event_queue",   Test_EventQueue },
+	{ "inject_burst",  Test_InjectBurst },
+	{ "sw_timer",      Test_SwTimer },
+	{ "debounce",      Test_Debounce },
+	{ "fsm",           Test_Fsm },
+	{ "pwm_fade",      Test_PwmFade },
+	{ "pwm_blink",     Test_PwmBlink },
+	{ "pattern",       Test_Pattern },
+	{ "power_stop",    Test_PowerStop },
+};
+
+int main(void)
+{
+	uint32 index;
+
+	for (index = 0; index < (sizeof(test_list) / sizeof(test_list[0])); index++)
+	{
+		uint32 failures = test_failures;
+
+		test_name = test_list[index].Name;
+		Test_Setup();
+		test_list[index].Run();
+		printf("%-16s %s\n", test_name, (test_failures == failures) ? "passed" : "FAILED");
+	}
+	printf("%lu checks, %lu failed\n", (unsigned long)test_checks, (unsigned long)test_failures);
+	return (test_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif /* HOST_BACKEND */
@@ -0,0 +1,37 @@
+#!/bin/sh
+# *****************************************************************************
+# Module: Host
+#
+# File Name: build.sh
+#
+# Description: Host build (HOST_BACKEND) of the drivers, of their test program and of the simulator
+#
+# Author: Omar Saad
+#
+# *****************************************************************************
+#
+# usage : sh Host/build.sh [output directory]    (default : _host in Vehicle_Project)
+#         then run <output directory>/host_test and <output directory>/sim [-q] scenario
+
+set -e
+cd "$(dirname "$0")/.."
+
+OUT=${1:-_host}
+CC=${CC:-gcc}
+CFLAGS="-std=gnu11 -O2 -g -Wall -Wextra -DHOST_BACKEND"
+
+INCLUDES="-ILib -IGpio -IRcc -INVIC -IGPT -IShadow -IPwm -ISwTimer -IPower -IDebounce \
+          -IEventQueue -ILatency -IInject -IFsm -IPattern -IHost"
+
+DRIVERS="Gpio/Gpio.c Rcc/Rcc.c NVIC/NVIC.c GPT/GPT.c Shadow/Shadow.c Pwm/Pwm.c SwTimer/SwTimer.c \
+         Power/Power.c Debounce/Debounce.c EventQueue/EventQueue.c Latency/Latency.c Inject/Inject.c \
+         Fsm/Fsm.c Pattern/Pattern.c Host/Host.c"
+
+mkdir -p "$OUT"
+
+# Checks of the drivers and services
+$CC $CFLAGS $INCLUDES $DRIVERS Host/Test.c -o "$OUT/host_test"
+
+# Simulator of the application : src/main.c unmodified, its main renamed app_main
+$CC $CFLAGS $INCLUDES -Dmain=app_main -c src/main.c -o "$OUT/app_main.o"
+$CC $CFLAGS $INCLUDES $DRIVERS Host/Sim.c "$OUT/app_main.o" -o "$OUT/sim"
@@ -0,0 +1,202 @@
+/* *****************************************************************************
+ * Module: Inject
+ *
+ * File Name: Inject.c
+ *
+ * Description: Source file for the software events injection (load tests without push buttons)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Inject.h"
+#include "GPT.h"
+#include "GPT_Private.h"
+#include "NVIC.h"
+#include "Macros.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* INJECT_TIMER counts in us */
+#define INJECT_TICK_FREQ  1000000UL
+
+/* Running script : current step and its remaining events */
+static const Inject_StepType * inject_script;
+static uint8 inject_num_of_steps;
+static uint8 inject_step;
+static uint16 inject_remaining;
+static volatile boolean inject_running;
+static volatile uint32 inject_fired;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Stop the counter and its interrupt, the script is over */
+static void Inject_Halt(TimxType * timer)
+{
+	inject_running = FALSE;
+	CLEAR_BIT(timer->CR1, 0);
+	CLEAR_BIT(timer->DIER, 0);
+}
+
+/* Load the period of the first step with events from the current one, FALSE at the end of the script */
+static boolean Inject_LoadStep(TimxType * timer)
+{
+	uint32 period;
+
+	while ((inject_step < inject_num_of_steps) && (inject_script[inject_step].Count == 0))
+	{
+		inject_step++;
+	}
+	if (inject_step >= inject_num_of_steps)
+	{
+		return FALSE;
+	}
+	inject_remaining = inject_script[inject_step].Count;
+	period = inject_script[inject_step].PeriodUs;
+	if (period < INJECT_MIN_PERIOD_US)
+	{
+		period = INJECT_MIN_PERIOD_US;
+	}
+	else if (period > INJECT_MAX_PERIOD_US)
+	{
+		period = INJECT_MAX_PERIOD_US;
+	}
+	/* the step starts now : the counter restarts from 0 (UG, no update flag with URS) */
+	timer->ARR = period - 1;
+	timer->EGR = 1;
+	return TRUE;
+}
+
+/* Update interrupt : one event of the current step */
+static void Inject_IrqHandler(uint8 GptTimer)
+{
+	TimxType * timer = GPT_GetRegisters(GptTimer);
+	const Inject_StepType * step;
+
+	/* clear the update flag (the status flags are cleared by writing 0) */
+	timer->SR = (uint32)~(1UL << 0);
+	if (inject_running == FALSE)
+	{
+		return;
+	}
+	step = &inject_script[inject_step];
+	if (step->Kind == INJECT_EXTI)
+	{
+		Exti_SoftwareTrigger(step->Target);
+		inject_fired++;
+	}
+	else if (step->Kind == INJECT_IRQ)
+	{
+		Nvic_SoftwareTrigger(step->Target);
+		inject_fired++;
+	}
+
+	inject_remaining--;
+	if (inject_remaining == 0)
+	{
+		inject_step++;
+		if (Inject_LoadStep(timer) == FALSE)
+		{
+			Inject_Halt(timer);
+		}
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Inject_Init
+ * Input : void
+ * Output : uint8 INJECT_OK, INJECT_NOK if INJECT_TIMER is owned by another driver
+ * Description :
+ * Take INJECT_TIMER and configure it to count in us, no script is running.
+ */
+uint8 Inject_Init(void){
+	TimxType * timer;
+
+	if (GPT_Claim(INJECT_TIMER, Inject_IrqHandler) != GPT_OK)
+	{
+		return INJECT_NOK;
+	}
+	timer = GPT_GetRegisters(INJECT_TIMER);
+	inject_running = FALSE;
+	inject_fired = 0;
+
+	/* Enable Clock for the TIMER and its interrupt on NVIC */
+	GPT_Enable(INJECT_TIMER);
+
+	/* Control Register 1 (CR1) Describtion:
+        URS Bit is set : Generate update flag from overflow only
+        DIR bit is 0 : (Up Conuter)
+        ARPE is 0 : the period of a new step is taken at once
+	 */
+	timer->CR1 = (1UL << 2);
+	timer->DIER = 0;
+	timer->PSC = GPT_GetPrescaler(INJECT_TICK_FREQ);
+	/* generate an update event (UG) to load the prescaler */
+	timer->EGR = 1;
+	return INJECT_OK;
+}
+
+/*
+ * Function : Inject_Run
+ * Input : Script, NumOfSteps
+ * Output : void
+ * Description :
+ * Start the script from its first step, a running script is replaced.
+ * The periods out of the limits are clamped.
+ */
+void Inject_Run(const Inject_StepType * Script, uint8 NumOfSteps){
+	TimxType * timer = GPT_GetRegisters(INJECT_TIMER);
+
+	Inject_Halt(timer);
+	inject_script = Script;
+	inject_num_of_steps = (Script != 0) ? NumOfSteps : 0;
+	inject_step = 0;
+	inject_fired = 0;
+	if (Inject_LoadStep(timer) == FALSE)
+	{
+		return;
+	}
+	/* drop an old update flag */
+	timer->SR = (uint32)~(1UL << 0);
+	inject_running = TRUE;
+	SET_BIT(timer->DIER, 0);
+	SET_BIT(timer->CR1, 0);
+}
+
+/*
+ * Function : Inject_Stop
+ * Input : void
+ * Output : void
+ * Description :
+ * Stop the running script, the events already made are still handled.
+ */
+void Inject_Stop(void){
+	Inject_Halt(GPT_GetRegisters(INJECT_TIMER));
+}
+
+/*
+ * Function : Inject_IsRunning
+ * Input : void
+ * Output : TRUE till the last event of the script is made, FALSE otherwise
+ */
+boolean Inject_IsRunning(void){
+	return inject_running;
+}
+
+/*
+ * Function : Inject_GetFiredCount
+ * Input : void
+ * Output : uint32 number of events made since Inject_Run (the waits are not counted)
+ */
+uint32 Inject_GetFiredCount(void){
+	return inject_fired;
+}
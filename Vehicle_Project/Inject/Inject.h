@@ -0,0 +1,116 @@
+/* *****************************************************************************
+ * Module: Inject
+ *
+ * File Name: Inject.h
+ *
+ * Description: Header file for the software events injection (load tests without push buttons)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef INJECT_H_
+#define INJECT_H_
+
+#include "Std_Types.h"
+#include "GPT.h"
+
+/* Inject Documentation */
+/* Synthetic interrupt events paced by a timer, to load the real interrupt handlers and the main loop
+ * A script is a table of steps, each step makes Count events at one period (1 us resolution) :
+ * software edges of an EXTI line (Exti_SoftwareTrigger), requests of any interrupt (Nvic_SoftwareTrigger),
+ * or only a wait. The events are made by the update interrupt of INJECT_TIMER.
+ * 1. Take INJECT_TIMER by calling Inject_Init(), then set the priority of its interrupt
+ *    (Nvic_SetPriority) : the injected interrupts with a higher priority preempt it at once.
+ * 2. Enable the EXTI lines and the interrupts to load as for the real events.
+ * 3. Run a script by calling Inject_Run( steps, number of steps ), the first event of a step comes
+ *    one period after its start. The table is read during the run : it must stay valid.
+ * 4. Check the end of the script by calling Inject_IsRunning(), stop it by calling Inject_Stop().
+ * 5. Read the number of events made since Inject_Run by calling Inject_GetFiredCount().
+ * A software edge of a line still pending is merged with it, as a real edge. The debounce service
+ * samples the pins : the software edges of a button load its interrupts but do not change its level.
+ * The host test program (Host/Test.c, inject_burst) runs burst scripts against the event queue.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+/* Timer of the injections (not used by the application) */
+#define INJECT_TIMER  GPT_TIM3
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Steps kinds */
+#define INJECT_EXTI  0   /* Target : EXTI line 0 .. 15 */
+#define INJECT_IRQ   1   /* Target : IRQ position of the vector table */
+#define INJECT_WAIT  2   /* no event, Count periods */
+
+/* Periods limits in us (16-bit auto reload at 1 MHz) */
+#define INJECT_MIN_PERIOD_US  1
+#define INJECT_MAX_PERIOD_US  65536
+
+/* Inject_Init status */
+#define INJECT_OK   0
+#define INJECT_NOK  1
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 Kind;        /* INJECT_EXTI, INJECT_IRQ, INJECT_WAIT */
+	uint8 Target;      /* EXTI line or IRQ position */
+	uint16 Count;      /* events of the step (0 : step skipped) */
+	uint32 PeriodUs;   /* time between two events, INJECT_MIN_PERIOD_US .. INJECT_MAX_PERIOD_US */
+} Inject_StepType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Inject_Init
+ * Input : void
+ * Output : uint8 INJECT_OK, INJECT_NOK if INJECT_TIMER is owned by another driver
+ * Description :
+ * Take INJECT_TIMER and configure it to count in us, no script is running.
+ */
+uint8 Inject_Init(void);
+
+/*
+ * Function : Inject_Run
+ * Input : Script, NumOfSteps
+ * Output : void
+ * Description :
+ * Start the script from its first step, a running script is replaced.
+ * The periods out of the limits are clamped.
+ */
+void Inject_Run(const Inject_StepType * Script, uint8 NumOfSteps);
+
+/*
+ * Function : Inject_Stop
+ * Input : void
+ * Output : void
+ * Description :
+ * Stop the running script, the events already made are still handled.
+ */
+void Inject_Stop(void);
+
+/*
+ * Function : Inject_IsRunning
+ * Input : void
+ * Output : TRUE till the last event of the script is made, FALSE otherwise
+ */
+boolean Inject_IsRunning(void);
+
+/*
+ * Function : Inject_GetFiredCount
+ * Input : void
+ * Output : uint32 number of events made since Inject_Run (the waits are not counted)
+ */
+uint32 Inject_GetFiredCount(void);
+
+#endif /* INJECT_H_ */
@@ -0,0 +1,217 @@
+/* *****************************************************************************
+ * Module: Latency
+ *
+ * File Name: Latency.c
+ *
+ * Description: Source file for the latency instrumentation (DWT cycle counter)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Latency.h"
+#include "Latency_Private.h"
+#include "Cpu.h"
+#include "NVIC.h"
+#include "Macros.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+#define LATENCY_NO_MEASURE  0xFFFFFFFFUL
+
+static Latency_StatsType latency_stats[LATENCY_NUM_OF_PROBES];
+
+/* Start stamps, and the probes waiting for their stop (one flag per probe : the probes run
+ * at different priorities) */
+static uint32 latency_start[LATENCY_NUM_OF_PROBES];
+static volatile boolean latency_started[LATENCY_NUM_OF_PROBES];
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Histogram bin of a measure : position of its highest set bit */
+static uint8 Latency_Bin(uint32 Cycles)
+{
+	uint8 bin;
+
+	if (Cycles < 2)
+	{
+		return 0;
+	}
+	bin = (uint8)(31 - CPU_COUNT_LEADING_ZEROS(Cycles));
+	return (bin < LATENCY_NUM_OF_BINS) ? bin : (LATENCY_NUM_OF_BINS - 1);
+}
+
+static void Latency_ClearStats(Latency_StatsType * Stats)
+{
+	uint8 bin;
+
+	Stats->Count = 0;
+	Stats->Min = LATENCY_NO_MEASURE;
+	Stats->Max = 0;
+	Stats->Last = 0;
+	for (bin = 0; bin < LATENCY_NUM_OF_BINS; bin++)
+	{
+		Stats->Histogram[bin] = 0;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Latency_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Enable the DWT cycle counter from 0 and clear all the probes.
+ */
+void Latency_Init(void){
+	uint8 probe;
+
+	for (probe = 0; probe < LATENCY_NUM_OF_PROBES; probe++)
+	{
+		latency_started[probe] = FALSE;
+		Latency_ClearStats(&latency_stats[probe]);
+	}
+
+	/* the DWT registers are only writable with the trace enabled */
+	SET_BIT(CORE_DEMCR, CORE_DEMCR_TRCENA);
+	DWT_CYCCNT = 0;
+	SET_BIT(DWT_CTRL, DWT_CTRL_CYCCNTENA);
+}
+
+/*
+ * Function : Latency_Now
+ * Input : void
+ * Output : uint32 core cycles counted by CYCCNT (wraps after 51 s at 84 MHz)
+ */
+uint32 Latency_Now(void){
+	return DWT_CYCCNT;
+}
+
+/*
+ * Function : Latency_Start
+ * Input : Probe
+ * Output : void
+ * Description :
+ * Stamp the start of a measure of the probe.
+ *  If the input probe is not correct, The function will not handle the request.
+ */
+void Latency_Start(uint8 Probe){
+	if (Probe >= LATENCY_NUM_OF_PROBES)
+	{
+		return;
+	}
+	latency_start[Probe] = DWT_CYCCNT;
+	latency_started[Probe] = TRUE;
+}
+
+/*
+ * Function : Latency_Stop
+ * Input : Probe
+ * Output : void
+ * Description :
+ * Stamp the end of the measure of the probe and add it to the statistics of the probe.
+ * Ignored when the probe was not started or when the probe is not correct.
+ */
+void Latency_Stop(uint8 Probe){
+	uint32 saved;
+	uint32 start;
+	uint32 now;
+
+	if (Probe >= LATENCY_NUM_OF_PROBES)
+	{
+		return;
+	}
+	/* the start, its flag and the stop stamp are read together : a start from an interrupt
+	 * is either before the section (measured now) or after it (kept for the next stop) */
+	saved = Nvic_EnterCritical(LATENCY_START_PRIORITY);
+	if (latency_started[Probe] == FALSE)
+	{
+		Nvic_ExitCritical(saved);
+		return;
+	}
+	start = latency_start[Probe];
+	now = DWT_CYCCNT;
+	latency_started[Probe] = FALSE;
+	Nvic_ExitCritical(saved);
+	/* modulo 2^32 : right across a wrap of the counter */
+	Latency_Record(Probe, now - start);
+}
+
+/*
+ * Function : Latency_Record
+ * Input : Probe, Cycles
+ * Output : void
+ * Description :
+ * Add a measure of Cycles core cycles to the statistics of the probe.
+ *  If the input probe is not correct, The function will not handle the request.
+ */
+void Latency_Record(uint8 Probe, uint32 Cycles){
+	Latency_StatsType * stats;
+
+	if (Probe >= LATENCY_NUM_OF_PROBES)
+	{
+		return;
+	}
+	stats = &latency_stats[Probe];
+	stats->Count++;
+	stats->Last = Cycles;
+	if (Cycles < stats->Min)
+	{
+		stats->Min = Cycles;
+	}
+	if (Cycles > stats->Max)
+	{
+		stats->Max = Cycles;
+	}
+	stats->Histogram[Latency_Bin(Cycles)]++;
+}
+
+/*
+ * Function : Latency_GetStats
+ * Input : Probe, Stats
+ * Output : TRUE if the statistics of the probe were copied to *Stats, FALSE if the probe is not correct
+ * Description :
+ * Read a consistent copy of the statistics (the interrupts are held up to LATENCY_START_PRIORITY
+ * during the copy), called from the main loop.
+ */
+boolean Latency_GetStats(uint8 Probe, Latency_StatsType * Stats){
+	uint32 saved;
+
+	if (Probe >= LATENCY_NUM_OF_PROBES)
+	{
+		return FALSE;
+	}
+	/* the stops (recording) run up to LATENCY_START_PRIORITY, the mask of the caller is kept */
+	saved = Nvic_EnterCritical(LATENCY_START_PRIORITY);
+	*Stats = latency_stats[Probe];
+	Nvic_ExitCritical(saved);
+	return TRUE;
+}
+
+/*
+ * Function : Latency_Clear
+ * Input : Probe
+ * Output : void
+ * Description :
+ * Clear the statistics of the probe, called from the main loop.
+ *  If the input probe is not correct, The function will not handle the request.
+ */
+void Latency_Clear(uint8 Probe){
+	uint32 saved;
+
+	if (Probe >= LATENCY_NUM_OF_PROBES)
+	{
+		return;
+	}
+	saved = Nvic_EnterCritical(LATENCY_START_PRIORITY);
+	Latency_ClearStats(&latency_stats[Probe]);
+	Nvic_ExitCritical(saved);
+}
@@ -0,0 +1,136 @@
+/* *****************************************************************************
+ * Module: Latency
+ *
+ * File Name: Latency.h
+ *
+ * Description: Header file for the latency instrumentation (DWT cycle counter)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include "Std_Types.h"
+
+/* Latency Documentation */
+/* Response times measured in core cycles with the DWT cycle counter (CYCCNT, 84 cycles per us at 84 MHz)
+ * A probe measures the time from its start stamp to its stop stamp : an interrupt handler from its
+ * entry to its exit, or a reaction from the interrupt that signals an event to the end of its handling
+ * in the main loop. Each probe keeps the count, the min, the max, the last measure and a histogram
+ * with one bin per power of 2 of cycles.
+ * 1. Start the cycle counter by calling Latency_Init().
+ * 2. Stamp the start of a measure by calling Latency_Start( probe ) (a new start replaces a pending one).
+ * 3. Stamp its end by calling Latency_Stop( probe ), a stop without start is ignored.
+ *    A time measured elsewhere can be added by calling Latency_Record( probe, cycles ).
+ * 4. Read the results from the main loop by calling Latency_GetStats( probe, stats ),
+ *    clear them by calling Latency_Clear( probe ).
+ * CYCCNT does not count while the core sleeps (WFI) : a probe must not span an idle of the main loop.
+ * The hardware edge of an interrupt is not visible to the software, the entry stamp is the first
+ * instruction of the handler. The measures of a probe are stopped (recorded) at one priority level,
+ * the probe can be started from a higher one (an interrupt signaling an event to the main loop) :
+ * a stop reads its start and the counter holding the interrupts up to LATENCY_START_PRIORITY (BASEPRI),
+ * so a start landing during the stop is kept for the next stop, never mixed with the current one.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+#define LATENCY_NUM_OF_PROBES  6
+
+/* Highest preemption priority of the interrupts that start probes (lowest value) */
+#define LATENCY_START_PRIORITY  1
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Histogram : bin n counts the measures of 2^n .. 2^(n+1) - 1 cycles (bin 0 : 0 and 1 cycle),
+ * the last bin counts all the measures from 2^23 cycles (about 100 ms at 84 MHz) */
+#define LATENCY_NUM_OF_BINS  24
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct {
+	uint32 Count;                          /* number of measures */
+	uint32 Min;                            /* cycles (0xFFFFFFFF without measure) */
+	uint32 Max;                            /* cycles */
+	uint32 Last;                           /* cycles of the last measure */
+	uint32 Histogram[LATENCY_NUM_OF_BINS];
+} Latency_StatsType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Latency_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Enable the DWT cycle counter from 0 and clear all the probes.
+ */
+void Latency_Init(void);
+
+/*
+ * Function : Latency_Now
+ * Input : void
+ * Output : uint32 core cycles counted by CYCCNT (wraps after 51 s at 84 MHz)
+ */
+uint32 Latency_Now(void);
+
+/*
+ * Function : Latency_Start
+ * Input : Probe
+ * Output : void
+ * Description :
+ * Stamp the start of a measure of the probe.
+ *  If the input probe is not correct, The function will not handle the request.
+ */
+void Latency_Start(uint8 Probe);
+
+/*
+ * Function : Latency_Stop
+ * Input : Probe
+ * Output : void
+ * Description :
+ * Stamp the end of the measure of the probe and add it to the statistics of the probe.
+ * Ignored when the probe was not started or when the probe is not correct.
+ */
+void Latency_Stop(uint8 Probe);
+
+/*
+ * Function : Latency_Record
+ * Input : Probe, Cycles
+ * Output : void
+ * Description :
+ * Add a measure of Cycles core cycles to the statistics of the probe.
+ *  If the input probe is not correct, The function will not handle the request.
+ */
+void Latency_Record(uint8 Probe, uint32 Cycles);
+
+/*
+ * Function : Latency_GetStats
+ * Input : Probe, Stats
+ * Output : TRUE if the statistics of the probe were copied to *Stats, FALSE if the probe is not correct
+ * Description :
+ * Read a consistent copy of the statistics (the interrupts are held up to LATENCY_START_PRIORITY
+ * during the copy), called from the main loop.
+ */
+boolean Latency_GetStats(uint8 Probe, Latency_StatsType * Stats);
+
+/*
+ * Function : Latency_Clear
+ * Input : Probe
+ * Output : void
+ * Description :
+ * Clear the statistics of the probe, called from the main loop.
+ *  If the input probe is not correct, The function will not handle the request.
+ */
+void Latency_Clear(uint8 Probe);
+
+#endif /* LATENCY_H_ */
@@ -0,0 +1,52 @@
+/* *****************************************************************************
+ * Module: Latency
+ *
+ * File Name: Latency_Private.h
+ *
+ * Description: Header Private file for the latency instrumentation (DWT cycle counter)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef LATENCY_PRIVATE_H_
+#define LATENCY_PRIVATE_H_
+
+#include "Std_Types.h"
+#include "Utils.h"
+
+
+/*******************************************************************************
+ *                                Memory Mapping                               *
+ *******************************************************************************/
+
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Simulated registers of the host backend */
+#define DWT_BASE_ADDR      ((uint8 *)Host_Access(HOST_DWT))
+#define SCB_BASE_ADDR      ((uint8 *)Host_Access(HOST_SCB))
+#else
+/* Data watchpoint and trace unit of the core */
+#define DWT_BASE_ADDR      0xE0001000
+/* System control block of the core (the debug registers follow it) */
+#define SCB_BASE_ADDR      0xE000ED00
+#endif
+
+/* DWT registers, CYCCNT is read twice around the measured code : it must not be cached */
+#define DWT_CTRL           REG32(DWT_BASE_ADDR, 0x00UL)
+#define DWT_CYCCNT         (*(volatile uint32 *)((DWT_BASE_ADDR) + 0x04UL))
+
+/* Debug exception and monitor control register */
+#define CORE_DEMCR         REG32(SCB_BASE_ADDR, 0xFCUL)
+
+/*******************************************************************************
+ *                                Registers Bits                               *
+ *******************************************************************************/
+
+/* DWT_CTRL */
+#define DWT_CTRL_CYCCNTENA  0   /* the cycle counter counts */
+
+/* CORE_DEMCR */
+#define CORE_DEMCR_TRCENA   24  /* DWT and ITM blocks enabled */
+
+#endif /* LATENCY_PRIVATE_H_ */
@@ -0,0 +1,54 @@
+/* *****************************************************************************
+ * Module: Cpu
+ *
+ * File Name: Cpu.h
+ *
+ * Description: Cortex-M4 core instructions (interrupt masking, priority masking, sleep, memory barrier
+ *              and bit scan)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef CPU_H_
+#define CPU_H_
+
+#include "Std_Types.h"
+
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Core of the host backend */
+#define CPU_DISABLE_INTERRUPTS()   Host_SetPrimask(TRUE)
+#define CPU_ENABLE_INTERRUPTS()    Host_SetPrimask(FALSE)
+#define CPU_WAIT_FOR_INTERRUPT()   Host_WaitForInterrupt()
+#define CPU_MEMORY_BARRIER()       __asm volatile ("" : : : "memory")
+#define CPU_GET_BASEPRI()          ((uint32)Host_GetBasepri())
+#define CPU_SET_BASEPRI(VALUE)     Host_SetBasepri((uint8)(VALUE), FALSE)
+#define CPU_RAISE_BASEPRI(VALUE)   Host_SetBasepri((uint8)(VALUE), TRUE)
+#else
+/* Set PRIMASK : only the faults and the NMI can preempt */
+#define CPU_DISABLE_INTERRUPTS()   __asm volatile ("cpsid i" : : : "memory")
+/* Clear PRIMASK : the pending interrupts are taken at once */
+#define CPU_ENABLE_INTERRUPTS()    __asm volatile ("cpsie i" : : : "memory")
+/* Sleep till an interrupt is pending, it wakes the core even when PRIMASK is set
+ * (the registers writes are completed before sleeping) */
+#define CPU_WAIT_FOR_INTERRUPT()   __asm volatile ("dsb\n\twfi" : : : "memory")
+/* The memory accesses before the barrier are done before the ones after it (compiler and core) */
+#define CPU_MEMORY_BARRIER()       __asm volatile ("dmb" : : : "memory")
+/* Priority mask : the interrupts with a group priority value >= BASEPRI are held (0 : no mask) */
+static inline uint32 Cpu_GetBasepri(void)
+{
+	uint32 value;
+	__asm volatile ("mrs %0, basepri" : "=r" (value));
+	return value;
+}
+#define CPU_GET_BASEPRI()          Cpu_GetBasepri()
+#define CPU_SET_BASEPRI(VALUE)     __asm volatile ("msr basepri, %0" : : "r" (VALUE) : "memory")
+/* Only a stronger mask is written (nested critical sections) */
+#define CPU_RAISE_BASEPRI(VALUE)   __asm volatile ("msr basepri_max, %0" : : "r" (VALUE) : "memory")
+#endif
+
+/* Number of zeros above the highest set bit (CLZ instruction), VALUE must not be 0 */
+#define CPU_COUNT_LEADING_ZEROS(VALUE)  ((uint8)__builtin_clz((unsigned int)(VALUE)))
+
+#endif /* CPU_H_ */
@@ -11,8 +11,14 @@ typedef signed char         sint8;          /*        -128 .. +127            */
 typedef unsigned char       uint8;          /*           0 .. 255             */
 typedef signed short        sint16;         /*      -32768 .. +32767          */
 typedef unsigned short      uint16;         /*           0 .. 65535           */
+#if defined(__LP64__) || defined(_LP64)
+/* 64-bit host build (HOST_BACKEND) : long is 64-bit, keep the 32-bit register width */
+typedef signed int          sint32;         /* -2147483648 .. +2147483647     */
+typedef unsigned int        uint32;         /*           0 .. 4294967295      */
+#else
 typedef signed long         sint32;         /* -2147483648 .. +2147483647     */
 typedef unsigned long       uint32;         /*           0 .. 4294967295      */
+#endif
 typedef unsigned long long  uint64;         /*       0..18446744073709551615  */
 typedef signed long long    sint64;         /*       0..18446744073709551615  */
 typedef float               float32;        /* 1.1754943635e-38 to 3.4028235e+38 */
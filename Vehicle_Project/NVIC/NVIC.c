@@ -13,47 +13,60 @@
 #include "NVIC_Private.h"
 #include "Macros.h"
 #include "Gpio.h"
+#include "Cpu.h"
 
 
-/* Static Function */
-// convert LineNum to the corresponding EXT_IRQ_POSITION
-uint8 Convert_Line_To_IRQ(uint8 LineNum){
-	uint8 IRQ_Position;
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* Lines served by the shared interrupt vectors */
+#define EXTI9_5_LINES    0x03E0UL
+#define EXTI15_10_LINES  0xFC00UL
+
+/* IRQ position of each EXTI line */
+static const uint8 exti_irq[EXTI_NUM_OF_LINES] = {
+	EXTI0_IRQ_POSITION,  EXTI1_IRQ_POSITION,  EXTI2_IRQ_POSITION,  EXTI3_IRQ_POSITION,
+	EXTI4_IRQ_POSITION,  EXTI5_IRQ_POSITION,  EXTI6_IRQ_POSITION,  EXTI7_IRQ_POSITION,
+	EXTI8_IRQ_POSITION,  EXTI9_IRQ_POSITION,  EXTI10_IRQ_POSITION, EXTI11_IRQ_POSITION,
+	EXTI12_IRQ_POSITION, EXTI13_IRQ_POSITION, EXTI14_IRQ_POSITION, EXTI15_IRQ_POSITION,
+};
+
+/* Handler of each EXTI line, 0 : the line is only acknowledged */
+static Exti_HandlerType exti_handler[EXTI_NUM_OF_LINES];
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Sub-priority bits of the 4 implemented bits for the current grouping (PRIGROUP 3 or less : none) */
+static uint8 Nvic_SubPriorityBits(void)
+{
+	uint8 grouping = (uint8)((SCB_AIRCR >> SCB_AIRCR_PRIGROUP) & 0x07);
+	return (grouping > NVIC_GROUP_4_0) ? (grouping - NVIC_GROUP_4_0) : 0;
+}
+
 
-	switch (LineNum)
+/* Serve the pending lines of an interrupt vector, the highest line first */
+static void Exti_Dispatch(uint32 Lines)
+{
+	uint32 pending = EXTI->PR & EXTI->IMR & Lines;
+
+	while (pending != 0)
 	{
-	case LINE_0:
-	case LINE_1:
-	case LINE_2:
-	case LINE_3:
-		IRQ_Position = LineNum + 6;
-		break;
-	case 4:
-		IRQ_Position = EXTI4_IRQ_POSITION;
-		break;
-	case 5:
-	case 6:
-	case 7:
-	case 8:
-	case 9:
-		IRQ_Position = EXTI5_9_IRQ_POSITION;
-		break;
-	case 10:
-	case 11:
-	case 12:
-	case 13:
-	case 14:
-	case 15:
-		IRQ_Position = EXTI10_15_IRQ_POSITION;
-		break;
-	default:
-		IRQ_Position = 0;
-		break;
+		/* one CLZ per pending line : the idle lines of the vector are never scanned */
+		uint8 line = (uint8)(31 - CPU_COUNT_LEADING_ZEROS(pending));
+
+		pending &= ~(1UL << line);
+		/* acknowledged before the handler : an edge during the handler is served again */
+		EXTI->PR = (1UL << line);
+		if (exti_handler[line] != 0)
+		{
+			exti_handler[line](line);
+		}
 	}
-	return IRQ_Position;
 }
 
-
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -121,11 +134,17 @@ void Exti_Init(uint8 PortName, uint8 LineNum ,uint8 Trigger_Type )
  */
 void  Exti_Enable(uint8 LineNum)
 {
+	uint8 IRQ_Position;
+
+	if (LineNum >= EXTI_NUM_OF_LINES)
+	{
+		return;
+	}
 	// convert LineNum to the corresponding EXT_IRQ_POSITION
-	uint8 IRQ_Position= Convert_Line_To_IRQ(LineNum);
+	IRQ_Position = exti_irq[LineNum];
 
 	/* Enable line on NVIC  */
-	SET_BIT(NVIC->ISER[(uint8)IRQ_Position/32], IRQ_Position % 32);
+	Nvic_EnableIrq(IRQ_Position);
 }
 
 /* Exti_Disable
@@ -133,10 +152,16 @@ void  Exti_Enable(uint8 LineNum)
  */
 void Exti_Disable(uint8 LineNum)
 {
+	uint8 IRQ_Position;
+
+	if (LineNum >= EXTI_NUM_OF_LINES)
+	{
+		return;
+	}
 	// convert LineNum to the corresponding EXT_IRQ_POSITION
-	uint8 IRQ_Position= Convert_Line_To_IRQ(LineNum);
-	/* Disable line on NVIC  */
-	SET_BIT(NVIC->ICER[(uint8)IRQ_Position/32], IRQ_Position % 32);
+	IRQ_Position = exti_irq[LineNum];
+	/* Disable line on NVIC (the other IRQs of the register stay enabled) */
+	Nvic_DisableIrq(IRQ_Position);
 }
 
 /* Exti_SetPriority
@@ -145,18 +170,222 @@ void Exti_Disable(uint8 LineNum)
 void Exti_SetPriority(uint8 IRQ_Position , uint8 Priority_Level){
 	// calculate the IPR register number from the IRQ_Position (x)
 	uint8 IPR_INDEX = (uint8) IRQ_Position / 4;
-	// calculate the start BIT position from the IRQ_Position
-	uint8 bit_shift = 4 * IPR_INDEX + (IRQ_Position % 4) * BYTE_OFFSET;
+	// calculate the start BIT position of the priority byte from the IRQ_Position
+	uint8 bit_shift = (IRQ_Position % 4) * BYTE_OFFSET;
 
-	/* clear first the 8 bits */
-	NVIC->IPR[IPR_INDEX] &=  (0x00 << bit_shift) ;
-	/* insert priority for the selected IRQ */
-	NVIC->IPR[IPR_INDEX] |= (Priority_Level << bit_shift);
+	/* clear first the 8 bits of the IRQ only, then insert its priority in the implemented bits */
+	NVIC->IPR[IPR_INDEX] = (NVIC->IPR[IPR_INDEX] & ~(0xFFUL << bit_shift)) |
+	                       ((uint32)((Priority_Level << NVIC_PRIO_SHIFT) & 0xFF) << bit_shift);
 }
 
 /* Exti_ClearPendingFlag
  * Description :Clear the pending flag of the External Interrupt by setting the pending flag bit in the Interrupt clear-pending register
  */
 void Exti_ClearPendingFlag(uint8 LineNum){
-	SET_BIT(EXTI->PR, LineNum);
+	/* PR bits are cleared by writing 1 : a read-modify-write would also clear the other pending lines */
+	EXTI->PR = (1UL << LineNum);
+}
+
+/*
+ * Function : Nvic_SetPriorityGrouping
+ * Input : Grouping
+ * Output : void
+ * Description :
+ * Split the 4 priority bits in preemption priority and sub-priority (NVIC_GROUP_4_0 .. NVIC_GROUP_0_4).
+ * Only the preemption priority decides if an interrupt preempts a running one,
+ * the sub-priority orders the pending interrupts of the same preemption priority.
+ * Set the grouping before the priorities, they are encoded with the current grouping.
+ */
+void Nvic_SetPriorityGrouping(uint8 Grouping){
+	if ((Grouping < NVIC_GROUP_4_0) || (Grouping > NVIC_GROUP_0_4))
+	{
+		return;
+	}
+	/* AIRCR is written with its key, the other bits (reset requests) are kept at 0 */
+	SCB_AIRCR = SCB_AIRCR_VECTKEY | ((uint32)Grouping << SCB_AIRCR_PRIGROUP);
+}
+
+/*
+ * Function : Nvic_SetPriority
+ * Input : IRQ_Position, PreemptPriority, SubPriority
+ * Output : void
+ * Description :
+ * Set the priority of any IRQ (EXTI, TIM2 .. TIM5, ...), 0 is the highest priority.
+ * The values are limited to the number of levels of the current grouping.
+ */
+void Nvic_SetPriority(uint8 IRQ_Position, uint8 PreemptPriority, uint8 SubPriority){
+	uint8 subBits = Nvic_SubPriorityBits();
+	uint8 preemptMax;
+	uint8 subMax;
+
+	preemptMax = (uint8)((1U << (NVIC_PRIO_BITS - subBits)) - 1);
+	subMax = (uint8)((1U << subBits) - 1);
+	if (PreemptPriority > preemptMax)
+	{
+		PreemptPriority = preemptMax;
+	}
+	if (SubPriority > subMax)
+	{
+		SubPriority = subMax;
+	}
+	Exti_SetPriority(IRQ_Position, (uint8)((PreemptPriority << subBits) | SubPriority));
+}
+
+/*
+ * Function : Nvic_EnableIrq
+ * Input : IRQ_Position
+ * Output : void
+ * Description :
+ * Enable any IRQ (EXTI, TIM2 .. TIM5, ...) on NVIC. The set-enable register is written with the bit
+ * of this IRQ alone (writing 0 has no effect), the other IRQs are not changed.
+ *  If the input IRQ_Position is not correct, The function will not handle the request.
+ */
+void Nvic_EnableIrq(uint8 IRQ_Position){
+	if (IRQ_Position >= NVIC_NUM_OF_IRQS)
+	{
+		return;
+	}
+	NVIC->ISER[IRQ_Position / 32] = (1UL << (IRQ_Position % 32));
+}
+
+/*
+ * Function : Nvic_DisableIrq
+ * Input : IRQ_Position
+ * Output : void
+ * Description :
+ * Disable any IRQ on NVIC. The clear-enable register is written with the bit of this IRQ alone
+ * (a read-modify-write would disable all the enabled IRQs of the register).
+ *  If the input IRQ_Position is not correct, The function will not handle the request.
+ */
+void Nvic_DisableIrq(uint8 IRQ_Position){
+	if (IRQ_Position >= NVIC_NUM_OF_IRQS)
+	{
+		return;
+	}
+	NVIC->ICER[IRQ_Position / 32] = (1UL << (IRQ_Position % 32));
+}
+
+/*
+ * Function : Nvic_EnterCritical
+ * Input : PreemptPriority
+ * Output : uint32 previous priority mask, to be given to Nvic_ExitCritical
+ * Description :
+ * Hold the interrupts with a preemption priority of PreemptPriority or lower (numerically >= PreemptPriority),
+ * the interrupts with a higher preemption priority still preempt (BASEPRI).
+ * The sections nest : an inner section never lowers the mask of an outer one.
+ * PreemptPriority 0 cannot be held by this mask, it is taken as 1
+ * (with NVIC_GROUP_0_4 there is no preemption level : nothing is held).
+ */
+uint32 Nvic_EnterCritical(uint8 PreemptPriority){
+	uint8 subBits = Nvic_SubPriorityBits();
+	uint8 preemptMax = (uint8)((1U << (NVIC_PRIO_BITS - subBits)) - 1);
+	uint32 saved = CPU_GET_BASEPRI();
+
+	if (PreemptPriority == 0)
+	{
+		PreemptPriority = 1;
+	}
+	if (PreemptPriority > preemptMax)
+	{
+		PreemptPriority = preemptMax;
+	}
+	/* BASEPRI_MAX : only written when it masks more than the current mask */
+	CPU_RAISE_BASEPRI((uint32)((PreemptPriority << (subBits + NVIC_PRIO_SHIFT)) & 0xFF));
+	return saved;
+}
+
+/*
+ * Function : Nvic_ExitCritical
+ * Input : Saved
+ * Output : void
+ * Description :
+ * Restore the priority mask returned by the matching Nvic_EnterCritical.
+ */
+void Nvic_ExitCritical(uint32 Saved){
+	CPU_SET_BASEPRI(Saved);
+}
+
+/*
+ * Function : Exti_SetHandler
+ * Input : LineNum, Handler
+ * Output : void
+ * Description :
+ * Register the function called with the line number at each edge of the line (0 : no handler).
+ * The pending flag of the line is cleared before its handler is called.
+ *  If the input line is not correct, The function will not handle the request.
+ */
+void Exti_SetHandler(uint8 LineNum, Exti_HandlerType Handler){
+	if (LineNum >= EXTI_NUM_OF_LINES)
+	{
+		return;
+	}
+	exti_handler[LineNum] = Handler;
+}
+
+/*
+ * Function : Exti_SoftwareTrigger
+ * Input : LineNum
+ * Output : void
+ * Description :
+ * Generate a software edge on the line (SWIER) : the line is pending as for a real edge when
+ * it is enabled. A new edge of a line still pending is merged with it.
+ *  If the input line is not correct, The function will not handle the request.
+ */
+void Exti_SoftwareTrigger(uint8 LineNum){
+	if (LineNum >= EXTI_NUM_OF_LINES)
+	{
+		return;
+	}
+	/* SWIER bits are only cleared with the pending flag : written alone, no read-modify-write */
+	EXTI->SWIER = (1UL << LineNum);
+}
+
+/*
+ * Function : Nvic_SoftwareTrigger
+ * Input : IRQ_Position
+ * Output : void
+ * Description :
+ * Pend the interrupt (NVIC_STIR), its handler runs when it is enabled and its priority allows it.
+ *  If the input IRQ_Position is not correct, The function will not handle the request.
+ */
+void Nvic_SoftwareTrigger(uint8 IRQ_Position){
+	if (IRQ_Position >= NVIC_NUM_OF_IRQS)
+	{
+		return;
+	}
+	NVIC_STIR = IRQ_Position;
+}
+
+/*******************************************************************************
+ *                      Interrupt Handlers                                     *
+ *******************************************************************************/
+
+void EXTI0_IRQHandler(void) {
+	Exti_Dispatch(1UL << LINE_0);
+}
+
+void EXTI1_IRQHandler(void) {
+	Exti_Dispatch(1UL << LINE_1);
+}
+
+void EXTI2_IRQHandler(void) {
+	Exti_Dispatch(1UL << LINE_2);
+}
+
+void EXTI3_IRQHandler(void) {
+	Exti_Dispatch(1UL << LINE_3);
+}
+
+void EXTI4_IRQHandler(void) {
+	Exti_Dispatch(1UL << LINE_4);
+}
+
+/* Lines 5 .. 9 share one vector */
+void EXTI9_5_IRQHandler(void) {
+	Exti_Dispatch(EXTI9_5_LINES);
+}
+
+/* Lines 10 .. 15 share one vector */
+void EXTI15_10_IRQHandler(void) {
+	Exti_Dispatch(EXTI15_10_LINES);
 }
@@ -40,6 +40,13 @@
 #define EXTI14_IRQ_POSITION 40
 #define EXTI15_IRQ_POSITION 40
 
+/* Priority grouping : preemption priority bits / sub-priority bits (AIRCR PRIGROUP value) */
+#define NVIC_GROUP_4_0  3   /* 16 preemption levels, no sub-priority (reset value of the application) */
+#define NVIC_GROUP_3_1  4   /* 8 preemption levels, 2 sub-priorities */
+#define NVIC_GROUP_2_2  5   /* 4 preemption levels, 4 sub-priorities */
+#define NVIC_GROUP_1_3  6   /* 2 preemption levels, 8 sub-priorities */
+#define NVIC_GROUP_0_4  7   /* no preemption, 16 sub-priorities */
+
 /* Ports */
 #define PORT_A	0
 #define PORT_B	1
@@ -66,11 +73,23 @@
 #define LINE_14	14
 #define LINE_15	15
 
+#define EXTI_NUM_OF_LINES  16
+
+/* Interrupts of the STM32F401 vector table */
+#define NVIC_NUM_OF_IRQS  85
+
 /* Trigger_Type */
 #define RISING_EDGE		0
 #define FALLING_EDGE	1
 #define RISING_FALLING_EDGE	 2
 
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Edge of an EXTI line, called from its interrupt with the line number */
+typedef void (*Exti_HandlerType)(uint8 LineNum);
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -95,7 +114,8 @@ void Exti_Enable(uint8 LineNum);
 void Exti_Disable(uint8 LineNum);
 
 /* Exti_SetPriority
- * Description :Set the priority of the External Interrupt by setting the priority of the IRQn
+ * Description :Set the priority of the External Interrupt by setting the priority of the IRQn,
+ * Priority_Level 0 (highest) .. 15 is written in the 4 implemented bits of its priority byte
  */
 void Exti_SetPriority(uint8 IRQ_Position , uint8 Priority_Level);
 
@@ -104,4 +124,102 @@ void Exti_SetPriority(uint8 IRQ_Position , uint8 Priority_Level);
  */
 void Exti_ClearPendingFlag(uint8 LineNum);
 
+/*
+ * Function : Exti_SetHandler
+ * Input : LineNum, Handler
+ * Output : void
+ * Description :
+ * Register the function called with the line number at each edge of the line (0 : no handler).
+ * The pending flag of the line is cleared before its handler is called.
+ *  If the input line is not correct, The function will not handle the request.
+ */
+void Exti_SetHandler(uint8 LineNum, Exti_HandlerType Handler);
+
+/*
+ * Function : Nvic_SetPriorityGrouping
+ * Input : Grouping
+ * Output : void
+ * Description :
+ * Split the 4 priority bits in preemption priority and sub-priority (NVIC_GROUP_4_0 .. NVIC_GROUP_0_4).
+ * Only the preemption priority decides if an interrupt preempts a running one,
+ * the sub-priority orders the pending interrupts of the same preemption priority.
+ * Set the grouping before the priorities, they are encoded with the current grouping.
+ */
+void Nvic_SetPriorityGrouping(uint8 Grouping);
+
+/*
+ * Function : Nvic_SetPriority
+ * Input : IRQ_Position, PreemptPriority, SubPriority
+ * Output : void
+ * Description :
+ * Set the priority of any IRQ (EXTI, TIM2 .. TIM5, ...), 0 is the highest priority.
+ * The values are limited to the number of levels of the current grouping.
+ */
+void Nvic_SetPriority(uint8 IRQ_Position, uint8 PreemptPriority, uint8 SubPriority);
+
+/*
+ * Function : Nvic_EnableIrq
+ * Input : IRQ_Position
+ * Output : void
+ * Description :
+ * Enable any IRQ (EXTI, TIM2 .. TIM5, ...) on NVIC. The set-enable register is written with the bit
+ * of this IRQ alone (writing 0 has no effect), the other IRQs are not changed.
+ *  If the input IRQ_Position is not correct, The function will not handle the request.
+ */
+void Nvic_EnableIrq(uint8 IRQ_Position);
+
+/*
+ * Function : Nvic_DisableIrq
+ * Input : IRQ_Position
+ * Output : void
+ * Description :
+ * Disable any IRQ on NVIC. The clear-enable register is written with the bit of this IRQ alone
+ * (a read-modify-write would disable all the enabled IRQs of the register).
+ *  If the input IRQ_Position is not correct, The function will not handle the request.
+ */
+void Nvic_DisableIrq(uint8 IRQ_Position);
+
+/*
+ * Function : Nvic_EnterCritical
+ * Input : PreemptPriority
+ * Output : uint32 previous priority mask, to be given to Nvic_ExitCritical
+ * Description :
+ * Hold the interrupts with a preemption priority of PreemptPriority or lower (numerically >= PreemptPriority),
+ * the interrupts with a higher preemption priority still preempt (BASEPRI).
+ * The sections nest : an inner section never lowers the mask of an outer one.
+ * PreemptPriority 0 cannot be held by this mask, it is taken as 1
+ * (with NVIC_GROUP_0_4 there is no preemption level : nothing is held).
+ */
+uint32 Nvic_EnterCritical(uint8 PreemptPriority);
+
+/*
+ * Function : Nvic_ExitCritical
+ * Input : Saved
+ * Output : void
+ * Description :
+ * Restore the priority mask returned by the matching Nvic_EnterCritical.
+ */
+void Nvic_ExitCritical(uint32 Saved);
+
+/*
+ * Function : Exti_SoftwareTrigger
+ * Input : LineNum
+ * Output : void
+ * Description :
+ * Generate a software edge on the line (SWIER) : the line is pending as for a real edge when
+ * it is enabled. A new edge of a line still pending is merged with it.
+ *  If the input line is not correct, The function will not handle the request.
+ */
+void Exti_SoftwareTrigger(uint8 LineNum);
+
+/*
+ * Function : Nvic_SoftwareTrigger
+ * Input : IRQ_Position
+ * Output : void
+ * Description :
+ * Pend the interrupt (NVIC_STIR), its handler runs when it is enabled and its priority allows it.
+ *  If the input IRQ_Position is not correct, The function will not handle the request.
+ */
+void Nvic_SoftwareTrigger(uint8 IRQ_Position);
+
 #endif /* NVIC_H_ */
@@ -1,4 +1,3 @@
-/* *****************************************************************************
 /* *****************************************************************************
  * Module: NVIC
  *
@@ -74,13 +73,34 @@ typedef struct {
 	uint32 IPR[60];
 } NvicType;
 
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Simulated registers of the host backend */
+#define NVIC_STIR (*(uint32 *)Host_Access(HOST_NVIC_STIR))
+#define SCB_AIRCR (*(uint32 *)((uint8 *)Host_Access(HOST_SCB) + 0x0C))
+
+#define EXTI ((ExtiType *)Host_Access(HOST_EXTI))
+#define SYSCFG ((SyscfgType *)Host_Access(HOST_SYSCFG))
+#define NVIC ((NvicType *)Host_Access(HOST_NVIC))
+#else
 /* NVIC_STIR (Software trigger interrupt) register is located in a separate block*/
 #define NVIC_STIR (*(uint32 *)0xE000EF00)
+/* SCB_AIRCR (Application interrupt and reset control) register holds the priority grouping */
+#define SCB_AIRCR (*(uint32 *)0xE000ED0C)
 
 /* Pointers to base address with structures data type */
 #define EXTI ((ExtiType *)EXTI_BASE_ADDR)
 #define SYSCFG ((SyscfgType *)SYSCFG_BASE_ADDR)
 #define NVIC ((NvicType *)NVIC_BASE_ADDR)
+#endif
+
+/* SCB_AIRCR : the register is written only with the VECTKEY in the upper half word */
+#define SCB_AIRCR_VECTKEY   (0x05FAUL << 16)
+#define SCB_AIRCR_PRIGROUP  8
+
+/* 4 priority bits implemented by the STM32F4, in the upper half of the priority byte */
+#define NVIC_PRIO_BITS   4
+#define NVIC_PRIO_SHIFT  (8 - NVIC_PRIO_BITS)
 
 
 #endif /* NVIC_PRIVATE_H_ */
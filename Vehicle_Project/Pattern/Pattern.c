@@ -0,0 +1,152 @@
+/* *****************************************************************************
+ * Module: Pattern
+ *
+ * File Name: Pattern.c
+ *
+ * Description: Source file for the LED patterns sequencer
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Pattern.h"
+#include "SwTimer.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* State of one slot */
+typedef struct {
+	const Pattern_Type * Pattern;   /* 0 : no pattern running */
+	uint8 Step;                     /* step being output */
+} Pattern_SlotType;
+
+static Pattern_SlotType pattern_slot[PATTERN_NUM_OF_SLOTS];
+
+static Pattern_OutputType pattern_output;
+static SwTimer_CallbackType pattern_expired;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Output the current step of the slot and wait for its end (a step of 0 ms ends the pattern) */
+static void Pattern_Output(uint8 Slot)
+{
+	Pattern_SlotType * slot = &pattern_slot[Slot];
+	const Pattern_StepType * step = &slot->Pattern->Steps[slot->Step];
+
+	if (pattern_output != 0)
+	{
+		pattern_output(step->Mask, step->Level & step->Mask);
+	}
+	if (step->DurationMs == 0)
+	{
+		slot->Pattern = 0;
+		SwTimer_Stop(PATTERN_FIRST_TIMER + Slot);
+	}
+	else
+	{
+		SwTimer_Start(PATTERN_FIRST_TIMER + Slot, step->DurationMs, 0, pattern_expired);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Pattern_Init
+ * Input : Output, Expired
+ * Output : void
+ * Description :
+ * Stop all the slots, the steps are given to Output and the timers of the slots call Expired.
+ */
+void Pattern_Init(Pattern_OutputType Output, SwTimer_CallbackType Expired){
+	uint8 slot;
+
+	pattern_output = Output;
+	pattern_expired = Expired;
+	for (slot = 0; slot < PATTERN_NUM_OF_SLOTS; slot++)
+	{
+		Pattern_Stop(slot);
+	}
+}
+
+/*
+ * Function : Pattern_Start
+ * Input : Slot, Pattern
+ * Output : void
+ * Description :
+ * Run the pattern in the slot from its first step, a running pattern of the slot is replaced.
+ *  If the input slot is not correct, The function will not handle the request.
+ */
+void Pattern_Start(uint8 Slot, const Pattern_Type * Pattern){
+	if ((Slot >= PATTERN_NUM_OF_SLOTS) || (Pattern == 0) || (Pattern->NumOfSteps == 0))
+	{
+		return;
+	}
+	pattern_slot[Slot].Pattern = Pattern;
+	pattern_slot[Slot].Step = 0;
+	Pattern_Output(Slot);
+}
+
+/*
+ * Function : Pattern_Stop
+ * Input : Slot
+ * Output : void
+ * Description :
+ * Stop the pattern of the slot, the LEDs keep their levels.
+ *  If the input slot is not correct, The function will not handle the request.
+ */
+void Pattern_Stop(uint8 Slot){
+	if (Slot >= PATTERN_NUM_OF_SLOTS)
+	{
+		return;
+	}
+	pattern_slot[Slot].Pattern = 0;
+	SwTimer_Stop(PATTERN_FIRST_TIMER + Slot);
+}
+
+/*
+ * Function : Pattern_Step
+ * Input : TimerId
+ * Output : TRUE if the timer belongs to a slot (its next step is output), FALSE otherwise
+ * Description :
+ * Go to the next step of the slot of the expired timer, called from the main loop.
+ */
+boolean Pattern_Step(uint8 TimerId){
+	uint8 slot;
+
+	if ((TimerId < PATTERN_FIRST_TIMER) || (TimerId >= (PATTERN_FIRST_TIMER + PATTERN_NUM_OF_SLOTS)))
+	{
+		return FALSE;
+	}
+	slot = TimerId - PATTERN_FIRST_TIMER;
+	if (pattern_slot[slot].Pattern == 0)
+	{
+		return TRUE;
+	}
+	pattern_slot[slot].Step++;
+	if (pattern_slot[slot].Step >= pattern_slot[slot].Pattern->NumOfSteps)
+	{
+		/* end of the timeline */
+		pattern_slot[slot].Pattern = 0;
+	}
+	else
+	{
+		Pattern_Output(slot);
+	}
+	return TRUE;
+}
+
+/*
+ * Function : Pattern_IsRunning
+ * Input : Slot
+ * Output : TRUE while the pattern of the slot waits for its next step, FALSE otherwise
+ */
+boolean Pattern_IsRunning(uint8 Slot){
+	return ((Slot < PATTERN_NUM_OF_SLOTS) && (pattern_slot[Slot].Pattern != 0)) ? TRUE : FALSE;
+}
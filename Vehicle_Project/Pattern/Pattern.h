@@ -0,0 +1,112 @@
+/* *****************************************************************************
+ * Module: Pattern
+ *
+ * File Name: Pattern.h
+ *
+ * Description: Header file for the LED patterns sequencer
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef PATTERN_H_
+#define PATTERN_H_
+
+#include "Std_Types.h"
+#include "SwTimer.h"
+
+/* Pattern Documentation */
+/* LED patterns described as const timelines of (pins mask, levels, duration) steps
+ * A pattern runs in a slot, each slot has its own software timer : patterns on different LEDs run
+ * together. The levels of a step are given to the output function of the application, which
+ * drives the LEDs (shadowed pins, PWM fades ...). The sequencer only works at the steps boundaries :
+ * one output call and one timer start per step, whatever the length of the pattern.
+ * 1. Start the clock and the software timers, then initialize the sequencer by calling
+ *    Pattern_Init( output, expiry ), expiry is the callback given to the timers of the slots.
+ * 2. Run a pattern by calling Pattern_Start( slot, pattern ) : its first step is output at once.
+ * 3. Give each expiry of a software timer to the sequencer by calling Pattern_Step( timer id )
+ *    from the main loop, it returns FALSE for the timers that are not used by the slots.
+ * 4. Stop a pattern by calling Pattern_Stop( slot ), the LEDs keep their levels.
+ * A step with a duration of 0 ends the pattern, the levels of the last step stay.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+/* Number of patterns running together */
+#define PATTERN_NUM_OF_SLOTS  2
+
+/* Software timers of the slots : PATTERN_FIRST_TIMER .. PATTERN_FIRST_TIMER + PATTERN_NUM_OF_SLOTS - 1 */
+#define PATTERN_FIRST_TIMER   1
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* One step of a timeline */
+typedef struct {
+	uint16 Mask;         /* LEDs written by the step */
+	uint16 Level;        /* levels of the LEDs of Mask (bit set : ON) */
+	uint32 DurationMs;   /* time till the next step, 0 : last step, the levels stay */
+} Pattern_StepType;
+
+/* A timeline of steps */
+typedef struct {
+	const Pattern_StepType * Steps;
+	uint8 NumOfSteps;
+} Pattern_Type;
+
+/* Output of the levels of a step, called from Pattern_Start and Pattern_Step */
+typedef void (*Pattern_OutputType)(uint16 Mask, uint16 Level);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Pattern_Init
+ * Input : Output, Expired
+ * Output : void
+ * Description :
+ * Stop all the slots, the steps are given to Output and the timers of the slots call Expired.
+ */
+void Pattern_Init(Pattern_OutputType Output, SwTimer_CallbackType Expired);
+
+/*
+ * Function : Pattern_Start
+ * Input : Slot, Pattern
+ * Output : void
+ * Description :
+ * Run the pattern in the slot from its first step, a running pattern of the slot is replaced.
+ *  If the input slot is not correct, The function will not handle the request.
+ */
+void Pattern_Start(uint8 Slot, const Pattern_Type * Pattern);
+
+/*
+ * Function : Pattern_Stop
+ * Input : Slot
+ * Output : void
+ * Description :
+ * Stop the pattern of the slot, the LEDs keep their levels.
+ *  If the input slot is not correct, The function will not handle the request.
+ */
+void Pattern_Stop(uint8 Slot);
+
+/*
+ * Function : Pattern_Step
+ * Input : TimerId
+ * Output : TRUE if the timer belongs to a slot (its next step is output), FALSE otherwise
+ * Description :
+ * Go to the next step of the slot of the expired timer, called from the main loop.
+ */
+boolean Pattern_Step(uint8 TimerId);
+
+/*
+ * Function : Pattern_IsRunning
+ * Input : Slot
+ * Output : TRUE while the pattern of the slot waits for its next step, FALSE otherwise
+ */
+boolean Pattern_IsRunning(uint8 Slot);
+
+#endif /* PATTERN_H_ */
@@ -0,0 +1,198 @@
+/* *****************************************************************************
+ * Module: Power
+ *
+ * File Name: Power.c
+ *
+ * Description: Source file for the STM32 low power idle (Sleep / Stop modes)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Power.h"
+#include "Power_Private.h"
+#include "Rcc.h"
+#include "GPT.h"
+#include "Cpu.h"
+#include "Macros.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* GPT clock ticks of one RTC sub second */
+#define POWER_TICKS_PER_SUBSECOND  ((RTC_ASYNC_DIVIDER * 1000UL * GPT_CLOCK_TICKS_PER_MS) / RCC_LSI_FREQ)
+
+/* Event signaled by an interrupt since the last idle */
+static volatile boolean power_wakeup = FALSE;
+
+/* Idle / busy measure : clock ticks at its start, ticks spent in Sleep mode and in Stop mode
+ * (timed by the RTC), sleeps and stops */
+static uint64 power_origin;
+static uint64 power_idle_ticks;
+static uint64 power_stop_ticks;
+static uint32 power_sleeps;
+static uint32 power_stops;
+
+/* The RTC counts on LSI : the Stop periods are timed */
+static boolean power_rtc_running = FALSE;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* RTC time of day in sub seconds, read twice till no sub second passed between the reads */
+static uint32 Power_ReadRtc(void)
+{
+	uint32 ssr;
+	uint32 tr;
+
+	do
+	{
+		ssr = RTC_SSR;
+		tr = RTC_TR;
+	} while (ssr != RTC_SSR);
+	return ((RTC_TR_HOURS(tr) * 3600UL) + (RTC_TR_MINUTES(tr) * 60UL) + RTC_TR_SECONDS(tr)) * RTC_SUBSECONDS +
+	       (RTC_SUBSECONDS - 1 - (ssr & 0xFFFFUL));
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Power_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Enable the power controller clock and select the Stop mode with the low power regulator
+ * and the flash in power down. Start the RTC on LSI to time the Stop periods.
+ * The idle and busy counters are zeroed, the GPT clock is not read :
+ * Power_Init can be called before GPT_ClockInit, the measure starts at Power_ClearStats().
+ */
+void Power_Init(void){
+	Rcc_Enable(RCC_PWR);
+
+	/* RTC on LSI, its counters read without the shadow registers (no wait for their sync
+	 * after a Stop), then its registers are locked again */
+	SET_BIT(PWR_CR, PWR_CR_DBP);
+	power_rtc_running = (Rcc_StartRtcClock() == RCC_OK) ? TRUE : FALSE;
+	if (power_rtc_running)
+	{
+		RTC_WPR = RTC_WPR_KEY1;
+		RTC_WPR = RTC_WPR_KEY2;
+		SET_BIT(RTC_CR, RTC_CR_BYPSHAD);
+		RTC_WPR = RTC_WPR_LOCK;
+	}
+
+	/* PDDS = 0 : Stop mode (not Standby), LPDS = 1 and FPDS = 1 : lowest Stop current */
+	CLEAR_BIT(PWR_CR, PWR_CR_PDDS);
+	SET_BIT(PWR_CR, PWR_CR_LPDS);
+	SET_BIT(PWR_CR, PWR_CR_FPDS);
+
+	/* Return to the main loop after each interrupt */
+	CLEAR_BIT(SCB_SCR, SCB_SCR_SLEEPONEXIT);
+	CLEAR_BIT(SCB_SCR, SCB_SCR_SLEEPDEEP);
+	power_wakeup = FALSE;
+	power_origin = 0;
+	power_idle_ticks = 0;
+	power_stop_ticks = 0;
+	power_sleeps = 0;
+	power_stops = 0;
+}
+
+/*
+ * Function : Power_Wakeup
+ * Input : void
+ * Output : void
+ * Description :
+ * Signal an event to the main loop, the next Power_Idle() returns without sleeping.
+ * Called from the interrupt handlers.
+ */
+void Power_Wakeup(void){
+	power_wakeup = TRUE;
+}
+
+/*
+ * Function : Power_Idle
+ * Input : Mode
+ * Output : void
+ * Description :
+ * Sleep in Mode (POWER_SLEEP / POWER_STOP) till the next interrupt, the interrupts are
+ * masked between the check of the events and the sleep so a wakeup can not be lost.
+ * Returns at once when an event was signaled since the previous call.
+ */
+void Power_Idle(uint8 Mode){
+	/* An interrupt arriving after the check stays pending and ends the sleep at once */
+	CPU_DISABLE_INTERRUPTS();
+	if (power_wakeup == FALSE)
+	{
+		if (Mode == POWER_STOP)
+		{
+			/* The GPT clock is frozen in Stop mode : the RTC times it (0 without the RTC) */
+			uint32 start = power_rtc_running ? Power_ReadRtc() : 0;
+
+			SET_BIT(SCB_SCR, SCB_SCR_SLEEPDEEP);
+			CPU_WAIT_FOR_INTERRUPT();
+			CLEAR_BIT(SCB_SCR, SCB_SCR_SLEEPDEEP);
+			/* The core wakes up from Stop on HSI : back to the configured clock tree
+			 * before the interrupt handlers run */
+			Rcc_RestoreClock();
+			if (power_rtc_running)
+			{
+				/* modulo one day : right across midnight of the RTC */
+				power_stop_ticks += (uint64)((Power_ReadRtc() + RTC_DAY_SUBSECONDS - start) % RTC_DAY_SUBSECONDS) *
+				                    POWER_TICKS_PER_SUBSECOND;
+			}
+			power_stops++;
+		}
+		else
+		{
+			/* The wakeup interrupt is still masked : the sleep ends at the second read */
+			uint64 start = GPT_GetTicks64();
+
+			CPU_WAIT_FOR_INTERRUPT();
+			power_idle_ticks += GPT_GetTicks64() - start;
+			power_sleeps++;
+		}
+	}
+	power_wakeup = FALSE;
+	/* The pending interrupt handlers run here */
+	CPU_ENABLE_INTERRUPTS();
+}
+
+/*
+ * Function : Power_GetStats
+ * Input : Stats
+ * Output : void
+ * Description :
+ * Copy the idle and busy times since Power_Init() or the last Power_ClearStats() to *Stats.
+ * Called from the main loop.
+ */
+void Power_GetStats(Power_StatsType * Stats){
+	/* the GPT clock does not count in Stop mode : GPT elapsed time = Sleep + busy,
+	 * the Stop time (RTC) is added to the idle time */
+	uint64 elapsed = GPT_GetTicks64() - power_origin;
+
+	Stats->IdleTicks = power_idle_ticks + power_stop_ticks;
+	Stats->StopTicks = power_stop_ticks;
+	Stats->BusyTicks = elapsed - power_idle_ticks;
+	Stats->Sleeps = power_sleeps;
+	Stats->Stops = power_stops;
+}
+
+/*
+ * Function : Power_ClearStats
+ * Input : void
+ * Output : void
+ * Description :
+ * Restart the idle and busy times measure from now. Called from the main loop.
+ */
+void Power_ClearStats(void){
+	power_origin = GPT_GetTicks64();
+	power_idle_ticks = 0;
+	power_stop_ticks = 0;
+	power_sleeps = 0;
+	power_stops = 0;
+}
@@ -0,0 +1,115 @@
+/* *****************************************************************************
+ * Module: Power
+ *
+ * File Name: Power.h
+ *
+ * Description: Header file for the STM32 low power idle (Sleep / Stop modes)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "Std_Types.h"
+
+/* Power Driver Documentation */
+/* Tickless idle of the main loop : the core sleeps between the events instead of polling.
+ * 1. Initialize the driver by calling Power_Init() function.
+ * 2. Call Power_Wakeup() from the interrupts that give work to the main loop
+ *    (buttons edges, software timers expiries).
+ * 3. At the end of each loop call Power_Idle( mode ), the core sleeps till the next interrupt
+ *    unless Power_Wakeup() was called since the previous Power_Idle().
+ * POWER_SLEEP : the core clock is stopped, the peripherals run, any interrupt wakes the core
+ *               (the software timers alarm programmed with the next deadline, the PWM ramps).
+ * POWER_STOP  : all the clocks are stopped, the timers do not count (the GPT clock is frozen),
+ *               only an EXTI line (push buttons) wakes the core, the clock tree of
+ *               Rcc_ConfigClock() is restored at the wakeup.
+ *               Select it only when no software timer and no PWM ramp is running.
+ * 4. Read the idle and the busy time of the core by calling Power_GetStats( stats ),
+ *    restart the measure by calling Power_ClearStats().
+ *    The times are GPT clock ticks : start the measure by calling Power_ClearStats() after GPT_ClockInit().
+ *    The time in Sleep and Stop modes is idle, the rest is busy : idle + busy is the wall time.
+ *    The GPT clock is frozen in Stop mode, the Stop periods are timed by the RTC clocked by LSI
+ *    (started by Power_Init) : 4 ms resolution, LSI accuracy, a Stop period shorter than 24 hours.
+ *    Without LSI the Stop periods are only counted.
+ *  */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Idle modes */
+#define POWER_SLEEP  0
+#define POWER_STOP   1
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct {
+	uint64 IdleTicks;   /* GPT clock ticks spent in Sleep and Stop modes */
+	uint64 StopTicks;   /* part of IdleTicks spent in Stop mode (RTC) */
+	uint64 BusyTicks;   /* GPT clock ticks spent running (handlers and main loop) */
+	uint32 Sleeps;      /* number of Sleep mode entries */
+	uint32 Stops;       /* number of Stop mode entries */
+} Power_StatsType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Power_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Enable the power controller clock and select the Stop mode with the low power regulator
+ * and the flash in power down. Start the RTC on LSI to time the Stop periods.
+ * The idle and busy counters are zeroed, the GPT clock is not read :
+ * Power_Init can be called before GPT_ClockInit, the measure starts at Power_ClearStats().
+ */
+void Power_Init(void);
+
+/*
+ * Function : Power_Wakeup
+ * Input : void
+ * Output : void
+ * Description :
+ * Signal an event to the main loop, the next Power_Idle() returns without sleeping.
+ * Called from the interrupt handlers.
+ */
+void Power_Wakeup(void);
+
+/*
+ * Function : Power_Idle
+ * Input : Mode
+ * Output : void
+ * Description :
+ * Sleep in Mode (POWER_SLEEP / POWER_STOP) till the next interrupt, the interrupts are
+ * masked between the check of the events and the sleep so a wakeup can not be lost.
+ * Returns at once when an event was signaled since the previous call.
+ */
+void Power_Idle(uint8 Mode);
+
+/*
+ * Function : Power_GetStats
+ * Input : Stats
+ * Output : void
+ * Description :
+ * Copy the idle and busy times since Power_Init() or the last Power_ClearStats() to *Stats.
+ * Called from the main loop.
+ */
+void Power_GetStats(Power_StatsType * Stats);
+
+/*
+ * Function : Power_ClearStats
+ * Input : void
+ * Output : void
+ * Description :
+ * Restart the idle and busy times measure from now. Called from the main loop.
+ */
+void Power_ClearStats(void);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,83 @@
+/* *****************************************************************************
+ * Module: Power
+ *
+ * File Name: Power_Private.h
+ *
+ * Description: Header Private file for the STM32 low power modes driver
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef POWER_PRIVATE_H_
+#define POWER_PRIVATE_H_
+
+#include "Std_Types.h"
+#include "Utils.h"
+
+
+/*******************************************************************************
+ *                                Memory Mapping                               *
+ *******************************************************************************/
+
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Simulated registers of the host backend */
+#define PWR_BASE_ADDR      ((uint8 *)Host_Access(HOST_PWR))
+#define RTC_BASE_ADDR      ((uint8 *)Host_Access(HOST_RTC))
+#define SCB_BASE_ADDR      ((uint8 *)Host_Access(HOST_SCB))
+#else
+#define PWR_BASE_ADDR      0x40007000
+#define RTC_BASE_ADDR      0x40002800
+/* System control block of the core */
+#define SCB_BASE_ADDR      0xE000ED00
+#endif
+
+/* Power controller registers */
+#define PWR_CR             REG32(PWR_BASE_ADDR, 0x00UL)
+#define PWR_CSR            REG32(PWR_BASE_ADDR, 0x04UL)
+
+/* Real time clock registers : time of the Stop periods */
+#define RTC_TR             REG32(RTC_BASE_ADDR, 0x00UL)
+#define RTC_CR             REG32(RTC_BASE_ADDR, 0x08UL)
+#define RTC_WPR            REG32(RTC_BASE_ADDR, 0x24UL)
+#define RTC_SSR            REG32(RTC_BASE_ADDR, 0x28UL)
+
+/* System control register */
+#define SCB_SCR            REG32(SCB_BASE_ADDR, 0x10UL)
+
+/*******************************************************************************
+ *                                Registers Bits                               *
+ *******************************************************************************/
+
+/* PWR_CR */
+#define PWR_CR_LPDS        0   /* low power regulator in Stop mode */
+#define PWR_CR_PDDS        1   /* deep sleep is Standby (1) or Stop (0) */
+#define PWR_CR_CWUF        2   /* clear the wakeup flag */
+#define PWR_CR_DBP         8   /* backup domain (RCC_BDCR, RTC) write access */
+#define PWR_CR_FPDS        9   /* flash in power down in Stop mode */
+
+/* RTC_CR */
+#define RTC_CR_BYPSHAD     5   /* TR and SSR read from the counters (no shadow registers sync) */
+
+/* RTC_WPR : write protection keys of the RTC registers, any other value locks them again */
+#define RTC_WPR_KEY1       0xCAUL
+#define RTC_WPR_KEY2       0x53UL
+#define RTC_WPR_LOCK       0xFFUL
+
+/* RTC_TR : BCD seconds (ST SU), minutes (MNT MNU), hours (HT HU, 24 hours format) */
+#define RTC_TR_SECONDS(TR)  ((((TR) >> 4) & 0x7UL) * 10 + ((TR) & 0xFUL))
+#define RTC_TR_MINUTES(TR)  ((((TR) >> 12) & 0x7UL) * 10 + (((TR) >> 8) & 0xFUL))
+#define RTC_TR_HOURS(TR)    ((((TR) >> 20) & 0x3UL) * 10 + (((TR) >> 16) & 0xFUL))
+
+/* Reset prescalers of the RTC : sub seconds at LSI / 128 (4 ms), 256 sub seconds per second,
+ * the time of day wraps after 24 hours */
+#define RTC_ASYNC_DIVIDER  128UL
+#define RTC_SUBSECONDS     256UL
+#define RTC_DAY_SUBSECONDS (24UL * 3600UL * RTC_SUBSECONDS)
+
+/* SCB_SCR */
+#define SCB_SCR_SLEEPONEXIT 1
+#define SCB_SCR_SLEEPDEEP   2
+
+#endif /* POWER_PRIVATE_H_ */
@@ -0,0 +1,455 @@
+/* *****************************************************************************
+ * Module: PWM
+ *
+ * File Name: Pwm.c
+ *
+ * Description: Source file for the STM32 PWM and fade driver (TIM3 / TIM4)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Pwm.h"
+#include "GPT.h"
+#include "GPT_Private.h"
+#include "Macros.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+/* GPT instance of each PWM timer */
+static const uint8 pwm_gpt_timer[PWM_NUM_OF_TIMERS] = { GPT_TIM3, GPT_TIM4 };
+
+/* Fixed point of the ramps : duty x 2^16 */
+#define PWM_FADE_SHIFT  16
+
+/* Ramp state of one channel */
+typedef struct {
+	uint32 Current;   /* current duty (fixed point) */
+	sint32 Step;      /* duty added at each PWM period (fixed point) */
+	uint32 Steps;     /* remaining steps, 0 : no ramp */
+	uint16 Target;    /* duty at the end of the ramp */
+} Pwm_FadeType;
+
+static Pwm_FadeType pwm_fade[PWM_NUM_OF_TIMERS][PWM_NUM_OF_CHANNELS];
+
+/* Compare values of a blinking channel : match at the counter value 0 (start of a period) or never */
+#define PWM_BLINK_MATCH     0
+#define PWM_BLINK_NO_MATCH  0xFFFF
+
+/* Output compare modes (OCxM) */
+#define PWM_OC_TOGGLE          0x03
+#define PWM_OC_FORCE_INACTIVE  0x04
+#define PWM_OC_PWM1            0x06
+
+/* Blink state of one channel */
+typedef struct {
+	uint32 OnPeriods;   /* PWM periods of the on level */
+	uint32 OffPeriods;  /* PWM periods of the off level */
+	uint32 Countdown;   /* PWM periods till the next edge is loaded */
+	uint32 Edges;       /* remaining edges, 2 per blink */
+	boolean Level;      /* level after the next edge */
+	boolean Pending;    /* the match of an edge is loaded in the compare register */
+	boolean Armed;      /* the channel is in toggle mode */
+} Pwm_BlinkType;
+
+static Pwm_BlinkType pwm_blink[PWM_NUM_OF_TIMERS][PWM_NUM_OF_CHANNELS];
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+static TimxType * Pwm_GetTimer(uint8 Timer)
+{
+	return GPT_GetRegisters(pwm_gpt_timer[Timer]);
+}
+
+static volatile uint32 * Pwm_GetCcr(TimxType * timer, uint8 Channel)
+{
+	switch (Channel)
+	{
+	case PWM_CHANNEL_1: return &timer->CCR1;
+	case PWM_CHANNEL_2: return &timer->CCR2;
+	case PWM_CHANNEL_3: return &timer->CCR3;
+	default:            return &timer->CCR4;
+	}
+}
+
+/* Set the output compare mode (OCxM) of the channel, CCxS = 00 : output, OCxPE = 1 : preload enabled */
+static void Pwm_SetOcMode(TimxType * timer, uint8 Channel, uint32 Mode)
+{
+	volatile uint32 * ccmr = (Channel <= PWM_CHANNEL_2) ? &timer->CCMR1 : &timer->CCMR2;
+	uint8 shift = ((Channel - 1) % 2) * 8;
+
+	*ccmr = (*ccmr & ~(0xFFUL << shift)) | ((0x08UL | (Mode << 4)) << shift);
+}
+
+/* Blink generator of the channel is running (edges to load or the last one not yet done) */
+static boolean Pwm_BlinkIsActive(const Pwm_BlinkType * blink)
+{
+	return ((blink->Edges != 0) || (blink->Pending == TRUE)) ? TRUE : FALSE;
+}
+
+/* Write a duty cycle in the preload compare register of the channel */
+static void Pwm_WriteDuty(uint8 Timer, uint8 Channel, uint16 Duty)
+{
+	*Pwm_GetCcr(Pwm_GetTimer(Timer), Channel) = ((uint32)Duty * PWM_PERIOD_TICKS) / PWM_DUTY_MAX;
+}
+
+/* Enable the update interrupt of the timer only while one of its channels is ramping or blinking */
+static void Pwm_UpdateInterrupt(uint8 Timer)
+{
+	TimxType * timer = Pwm_GetTimer(Timer);
+	uint8 index;
+
+	for (index = 0; index < PWM_NUM_OF_CHANNELS; index++)
+	{
+		if ((pwm_fade[Timer][index].Steps != 0) || Pwm_BlinkIsActive(&pwm_blink[Timer][index]))
+		{
+			if (BIT_IS_CLEAR(timer->DIER, 0))
+			{
+				/* drop the update flag of the past periods, the first step is one period later */
+				timer->SR = (uint32)~(1UL << 0);
+				SET_BIT(timer->DIER, 0);
+			}
+			return;
+		}
+	}
+	CLEAR_BIT(timer->DIER, 0);
+}
+
+/* One ramp step of all the ramping channels of the timer (one PWM period) */
+static void Pwm_FadeStep(uint8 Timer)
+{
+	uint8 index;
+
+	for (index = 0; index < PWM_NUM_OF_CHANNELS; index++)
+	{
+		Pwm_FadeType * fade = &pwm_fade[Timer][index];
+
+		if (fade->Steps == 0)
+		{
+			continue;
+		}
+		fade->Steps--;
+		if (fade->Steps == 0)
+		{
+			/* Last step : land exactly on the target */
+			fade->Current = (uint32)fade->Target << PWM_FADE_SHIFT;
+		}
+		else
+		{
+			fade->Current = (uint32)((sint32)fade->Current + fade->Step);
+		}
+		Pwm_WriteDuty(Timer, index + 1, (uint16)(fade->Current >> PWM_FADE_SHIFT));
+	}
+}
+
+/* One period of all the blinking channels of the timer :
+ * an edge is loaded as a match at the counter value 0 in the preloaded compare register,
+ * the update event moves it to the active register and the toggle happens at the start of the period,
+ * the match is removed one period later. */
+static void Pwm_BlinkStep(uint8 Timer)
+{
+	TimxType * timer = Pwm_GetTimer(Timer);
+	uint8 index;
+
+	for (index = 0; index < PWM_NUM_OF_CHANNELS; index++)
+	{
+		Pwm_BlinkType * blink = &pwm_blink[Timer][index];
+		volatile uint32 * ccr = Pwm_GetCcr(timer, index + 1);
+
+		if (Pwm_BlinkIsActive(blink) == FALSE)
+		{
+			continue;
+		}
+		if (blink->Armed == FALSE)
+		{
+			/* the update event loaded the no match value : toggle mode can be taken */
+			Pwm_SetOcMode(timer, index + 1, PWM_OC_TOGGLE);
+			blink->Armed = TRUE;
+		}
+		if (blink->Pending == TRUE)
+		{
+			*ccr = PWM_BLINK_NO_MATCH;
+			blink->Pending = FALSE;
+		}
+		if (blink->Edges != 0)
+		{
+			blink->Countdown--;
+			if (blink->Countdown == 0)
+			{
+				*ccr = PWM_BLINK_MATCH;
+				blink->Pending = TRUE;
+				blink->Edges--;
+				blink->Countdown = (blink->Level == TRUE) ? blink->OnPeriods : blink->OffPeriods;
+				blink->Level = (blink->Level == TRUE) ? FALSE : TRUE;
+			}
+		}
+	}
+}
+
+/* Update interrupt of TIM3 / TIM4, forwarded by the GPT driver */
+static void Pwm_IrqHandler(uint8 GptTimer)
+{
+	uint8 timer = (GptTimer == pwm_gpt_timer[PWM_TIM3]) ? PWM_TIM3 : PWM_TIM4;
+
+	/* clear the update flag (the status flags are cleared by writing 0) */
+	Pwm_GetTimer(timer)->SR = (uint32)~(1UL << 0);
+	Pwm_FadeStep(timer);
+	Pwm_BlinkStep(timer);
+	Pwm_UpdateInterrupt(timer);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Pwm_Init
+ * Input : Timer
+ * Output : void
+ * Description :
+ * Initialize the timer as an up counter with the PWM period of the static configuration,
+ * the auto reload register is preloaded and the counter is started.
+ *  If the input timer is not correct or is owned by another driver, The function will not handle the request.
+ */
+void Pwm_Init(uint8 Timer){
+	TimxType * timer;
+
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (GPT_Claim(pwm_gpt_timer[Timer], Pwm_IrqHandler) != GPT_OK))
+	{
+		return;
+	}
+	timer = Pwm_GetTimer(Timer);
+
+	/* Enable Clock for the TIMER and its interrupt on NVIC (update interrupt of the ramps,
+	 * enabled in the timer only while a ramp is running) */
+	GPT_Enable(pwm_gpt_timer[Timer]);
+
+	/* Control Register 1 (CR1) Describtion:
+        URS Bit is set : Generate update flag from overflow only
+        DIR bit is 0 : (Up Conuter)
+        CMS is 00 : Edge alligned mode
+        ARPE is 1 : Auto reload preload enabled (the period changes at the end of a period)
+	 */
+	SET_BIT(timer->CR1, 2);
+	SET_BIT(timer->CR1, 7);
+	timer->PSC = GPT_GetPrescaler(PWM_TICK_FREQ);
+	timer->ARR = PWM_PERIOD_TICKS - 1;
+	/* generate an update event (UG) to load the prescaler and the auto reload */
+	timer->EGR = 1;
+
+	/* Start the counter */
+	SET_BIT(timer->CR1, 0);
+}
+
+/*
+ * Function : Pwm_ConfigChannel
+ * Input : Timer, Channel
+ * Output : void
+ * Description :
+ * Configure the channel in PWM mode 1 with a preloaded compare register and enable its output,
+ * the channel starts with a duty cycle of 0.
+ *  If the input timer or channel are not correct, The function will not handle the request.
+ */
+void Pwm_ConfigChannel(uint8 Timer, uint8 Channel){
+	TimxType * timer;
+
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return;
+	}
+	timer = Pwm_GetTimer(Timer);
+
+	pwm_fade[Timer][Channel - 1].Steps = 0;
+	pwm_fade[Timer][Channel - 1].Current = 0;
+	pwm_fade[Timer][Channel - 1].Target = PWM_DUTY_OFF;
+	pwm_blink[Timer][Channel - 1].Edges = 0;
+	pwm_blink[Timer][Channel - 1].Pending = FALSE;
+	*Pwm_GetCcr(timer, Channel) = 0;
+
+	/* OCxM = 110 : PWM mode 1 */
+	Pwm_SetOcMode(timer, Channel, PWM_OC_PWM1);
+	/* CCxE = 1 : output enabled, CCxP = 0 : active high */
+	timer->CCER = (timer->CCER & ~(0x0FUL << ((Channel - 1) * 4))) | (0x01UL << ((Channel - 1) * 4));
+}
+
+/*
+ * Function : Pwm_SetDuty
+ * Input : Timer, Channel, Duty
+ * Output : void
+ * Description :
+ * Stop the ramp of the channel and set its duty cycle (0 .. PWM_DUTY_MAX),
+ * a higher duty is limited to PWM_DUTY_MAX.
+ */
+void Pwm_SetDuty(uint8 Timer, uint8 Channel, uint16 Duty){
+	Pwm_FadeType * fade;
+
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return;
+	}
+	if (Duty > PWM_DUTY_MAX)
+	{
+		Duty = PWM_DUTY_MAX;
+	}
+	fade = &pwm_fade[Timer][Channel - 1];
+	fade->Steps = 0;
+	fade->Target = Duty;
+	fade->Current = (uint32)Duty << PWM_FADE_SHIFT;
+	Pwm_WriteDuty(Timer, Channel, Duty);
+	Pwm_UpdateInterrupt(Timer);
+}
+
+/*
+ * Function : Pwm_GetDuty
+ * Input : Timer, Channel
+ * Output : uint16 current duty cycle of the channel (0 .. PWM_DUTY_MAX)
+ */
+uint16 Pwm_GetDuty(uint8 Timer, uint8 Channel){
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return PWM_DUTY_OFF;
+	}
+	return (uint16)(pwm_fade[Timer][Channel - 1].Current >> PWM_FADE_SHIFT);
+}
+
+/*
+ * Function : Pwm_StartFade
+ * Input : Timer, Channel, TargetDuty, DurationMs
+ * Output : void
+ * Description :
+ * Ramp the duty cycle of the channel linearly from its current value to TargetDuty in DurationMs.
+ * If the channel is already at TargetDuty or already ramping to it, the call does nothing,
+ * so it can be called at every loop of the application.
+ * A DurationMs shorter than one PWM period sets the duty at once.
+ */
+void Pwm_StartFade(uint8 Timer, uint8 Channel, uint16 TargetDuty, uint32 DurationMs){
+	Pwm_FadeType * fade;
+	uint32 steps = DurationMs / PWM_PERIOD_MS;
+
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return;
+	}
+	if (TargetDuty > PWM_DUTY_MAX)
+	{
+		TargetDuty = PWM_DUTY_MAX;
+	}
+	fade = &pwm_fade[Timer][Channel - 1];
+	if (fade->Target == TargetDuty)
+	{
+		/* Already there or on the way */
+		return;
+	}
+	if (steps == 0)
+	{
+		Pwm_SetDuty(Timer, Channel, TargetDuty);
+		return;
+	}
+
+	/* The update interrupt is stopped while the ramp is loaded */
+	CLEAR_BIT(Pwm_GetTimer(Timer)->DIER, 0);
+	fade->Target = TargetDuty;
+	fade->Step = (sint32)((((sint32)TargetDuty << PWM_FADE_SHIFT) - (sint32)fade->Current) / (sint32)steps);
+	fade->Steps = steps;
+	Pwm_UpdateInterrupt(Timer);
+}
+
+/*
+ * Function : Pwm_IsFading
+ * Input : Timer, Channel
+ * Output : TRUE while a ramp is running on the channel, FALSE otherwise
+ */
+boolean Pwm_IsFading(uint8 Timer, uint8 Channel){
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return FALSE;
+	}
+	return (pwm_fade[Timer][Channel - 1].Steps != 0) ? TRUE : FALSE;
+}
+
+/*
+ * Function : Pwm_StartBlink
+ * Input : Timer, Channel, OnMs, OffMs, Count
+ * Output : void
+ * Description :
+ * Blink the output of the channel Count times : OnMs at the high level then OffMs at the low level.
+ * The channel is taken out of PWM mode : its output is toggled by the compare match (toggle on match),
+ * the edges are at the start of the PWM periods, the first one is at most 2 periods after the call.
+ * A running blink of the channel is restarted. Pwm_ConfigChannel gives the channel back to PWM mode.
+ * OnMs and OffMs shorter than one PWM period are taken as one period.
+ *  If the input timer or channel are not correct, The function will not handle the request.
+ */
+void Pwm_StartBlink(uint8 Timer, uint8 Channel, uint32 OnMs, uint32 OffMs, uint32 Count){
+	TimxType * timer;
+	Pwm_BlinkType * blink;
+
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return;
+	}
+	timer = Pwm_GetTimer(Timer);
+	blink = &pwm_blink[Timer][Channel - 1];
+
+	/* The update interrupt is stopped while the blink is loaded */
+	CLEAR_BIT(timer->DIER, 0);
+	pwm_fade[Timer][Channel - 1].Steps = 0;
+
+	/* Low level till the first edge, the channel is armed in toggle mode at the next update event */
+	Pwm_SetOcMode(timer, Channel, PWM_OC_FORCE_INACTIVE);
+	*Pwm_GetCcr(timer, Channel) = PWM_BLINK_NO_MATCH;
+	/* CCxE = 1 : output enabled, CCxP = 0 : active high */
+	timer->CCER = (timer->CCER & ~(0x0FUL << ((Channel - 1) * 4))) | (0x01UL << ((Channel - 1) * 4));
+
+	blink->OnPeriods = (OnMs >= PWM_PERIOD_MS) ? (OnMs / PWM_PERIOD_MS) : 1;
+	blink->OffPeriods = (OffMs >= PWM_PERIOD_MS) ? (OffMs / PWM_PERIOD_MS) : 1;
+	blink->Countdown = 1;
+	blink->Edges = 2 * Count;
+	blink->Level = TRUE;
+	blink->Pending = FALSE;
+	blink->Armed = FALSE;
+	Pwm_UpdateInterrupt(Timer);
+}
+
+/*
+ * Function : Pwm_StopBlink
+ * Input : Timer, Channel
+ * Output : void
+ * Description :
+ * Stop the blink of the channel and force its output to the low level.
+ * It can be called when the channel is not blinking (the output is only forced low).
+ */
+void Pwm_StopBlink(uint8 Timer, uint8 Channel){
+	TimxType * timer;
+
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return;
+	}
+	timer = Pwm_GetTimer(Timer);
+
+	CLEAR_BIT(timer->DIER, 0);
+	pwm_blink[Timer][Channel - 1].Edges = 0;
+	pwm_blink[Timer][Channel - 1].Pending = FALSE;
+	Pwm_SetOcMode(timer, Channel, PWM_OC_FORCE_INACTIVE);
+	/* CCxE = 1 : output enabled (driven low), CCxP = 0 : active high */
+	timer->CCER = (timer->CCER & ~(0x0FUL << ((Channel - 1) * 4))) | (0x01UL << ((Channel - 1) * 4));
+	Pwm_UpdateInterrupt(Timer);
+}
+
+/*
+ * Function : Pwm_IsBlinking
+ * Input : Timer, Channel
+ * Output : TRUE while a blink is running on the channel, FALSE otherwise
+ */
+boolean Pwm_IsBlinking(uint8 Timer, uint8 Channel){
+	if ((Timer >= PWM_NUM_OF_TIMERS) || (Channel < PWM_CHANNEL_1) || (Channel > PWM_CHANNEL_4))
+	{
+		return FALSE;
+	}
+	return Pwm_BlinkIsActive(&pwm_blink[Timer][Channel - 1]);
+}
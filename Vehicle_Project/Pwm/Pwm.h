@@ -0,0 +1,161 @@
+/* *****************************************************************************
+ * Module: PWM
+ *
+ * File Name: Pwm.h
+ *
+ * Description: Header file for the STM32 PWM and fade driver (TIM3 / TIM4)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef PWM_H_
+#define PWM_H_
+
+#include "Std_Types.h"
+
+/* PWM Driver Documentation */
+/* Edge aligned PWM (mode 1) on the capture/compare channels of TIM3 and TIM4
+ * 1. Initialize the timer by calling Pwm_Init( timer ) function.
+ * 2. Configure the pin of the channel as GPIO_AF with its alternate function
+ *    (TIM3 : GPIO_AF2, TIM4 : GPIO_AF2), then call Pwm_ConfigChannel( timer, channel ).
+ * 3. Set a duty cycle by calling Pwm_SetDuty( timer, channel, duty ), duty is in per mille.
+ * 4. Ramp the duty cycle by calling Pwm_StartFade( timer, channel, target duty, time in ms ).
+ * 5. Check the end of the ramp by calling Pwm_IsFading( timer, channel ).
+ * 6. Blink a channel by calling Pwm_StartBlink( timer, channel, on ms, off ms, count ),
+ *    stop it with Pwm_StopBlink( timer, channel ) and check its end with Pwm_IsBlinking( timer, channel ).
+ * The compare registers are preloaded, the hardware takes a new duty at the start of a period.
+ * A ramp moves the duty one step at each PWM period from the update interrupt of the timer,
+ * A blink uses the output compare toggle on match mode : each edge is a match at the counter value 0
+ * loaded in the preloaded compare register, so the edges are exactly on the periods boundaries
+ * whatever the loop and interrupt latencies, the update interrupt only counts the periods.
+ * The update interrupt is only enabled while a ramp or a blink is running on the timer.
+ * The timer is taken from the GPT driver (GPT_Claim), its interrupt is forwarded by GPT.
+ * The prescaler is derived from the RCC clocks (Rcc_GetClocks), configure the clock tree first.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+/* 1 tick = 1 us, the prescaler is derived from the APB1 timers clock by Pwm_Init */
+#define PWM_TICK_FREQ      1000000UL
+/* 1000 ticks period : PWM frequency 1 kHz */
+#define PWM_PERIOD_TICKS   1000
+/* PWM period in ms (one fade step each period) */
+#define PWM_PERIOD_MS      1
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Timers */
+#define PWM_TIM3  0
+#define PWM_TIM4  1
+#define PWM_NUM_OF_TIMERS 2
+
+/* Channels */
+#define PWM_CHANNEL_1  1
+#define PWM_CHANNEL_2  2
+#define PWM_CHANNEL_3  3
+#define PWM_CHANNEL_4  4
+#define PWM_NUM_OF_CHANNELS 4
+
+/* Duty cycle in per mille */
+#define PWM_DUTY_OFF  0
+#define PWM_DUTY_MAX  1000
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Pwm_Init
+ * Input : Timer
+ * Output : void
+ * Description :
+ * Initialize the timer as an up counter with the PWM period of the static configuration,
+ * the auto reload register is preloaded and the counter is started.
+ *  If the input timer is not correct or is owned by another driver, The function will not handle the request.
+ */
+void Pwm_Init(uint8 Timer);
+
+/*
+ * Function : Pwm_ConfigChannel
+ * Input : Timer, Channel
+ * Output : void
+ * Description :
+ * Configure the channel in PWM mode 1 with a preloaded compare register and enable its output,
+ * the channel starts with a duty cycle of 0.
+ *  If the input timer or channel are not correct, The function will not handle the request.
+ */
+void Pwm_ConfigChannel(uint8 Timer, uint8 Channel);
+
+/*
+ * Function : Pwm_SetDuty
+ * Input : Timer, Channel, Duty
+ * Output : void
+ * Description :
+ * Stop the ramp of the channel and set its duty cycle (0 .. PWM_DUTY_MAX),
+ * a higher duty is limited to PWM_DUTY_MAX.
+ */
+void Pwm_SetDuty(uint8 Timer, uint8 Channel, uint16 Duty);
+
+/*
+ * Function : Pwm_GetDuty
+ * Input : Timer, Channel
+ * Output : uint16 current duty cycle of the channel (0 .. PWM_DUTY_MAX)
+ */
+uint16 Pwm_GetDuty(uint8 Timer, uint8 Channel);
+
+/*
+ * Function : Pwm_StartFade
+ * Input : Timer, Channel, TargetDuty, DurationMs
+ * Output : void
+ * Description :
+ * Ramp the duty cycle of the channel linearly from its current value to TargetDuty in DurationMs.
+ * If the channel is already at TargetDuty or already ramping to it, the call does nothing,
+ * so it can be called at every loop of the application.
+ * A DurationMs shorter than one PWM period sets the duty at once.
+ */
+void Pwm_StartFade(uint8 Timer, uint8 Channel, uint16 TargetDuty, uint32 DurationMs);
+
+/*
+ * Function : Pwm_IsFading
+ * Input : Timer, Channel
+ * Output : TRUE while a ramp is running on the channel, FALSE otherwise
+ */
+boolean Pwm_IsFading(uint8 Timer, uint8 Channel);
+
+/*
+ * Function : Pwm_StartBlink
+ * Input : Timer, Channel, OnMs, OffMs, Count
+ * Output : void
+ * Description :
+ * Blink the output of the channel Count times : OnMs at the high level then OffMs at the low level.
+ * The channel is taken out of PWM mode : its output is toggled by the compare match (toggle on match),
+ * the edges are at the start of the PWM periods, the first one is at most 2 periods after the call.
+ * A running blink of the channel is restarted. Pwm_ConfigChannel gives the channel back to PWM mode.
+ * OnMs and OffMs shorter than one PWM period are taken as one period.
+ *  If the input timer or channel are not correct, The function will not handle the request.
+ */
+void Pwm_StartBlink(uint8 Timer, uint8 Channel, uint32 OnMs, uint32 OffMs, uint32 Count);
+
+/*
+ * Function : Pwm_StopBlink
+ * Input : Timer, Channel
+ * Output : void
+ * Description :
+ * Stop the blink of the channel and force its output to the low level.
+ * It can be called when the channel is not blinking (the output is only forced low).
+ */
+void Pwm_StopBlink(uint8 Timer, uint8 Channel);
+
+/*
+ * Function : Pwm_IsBlinking
+ * Input : Timer, Channel
+ * Output : TRUE while a blink is running on the channel, FALSE otherwise
+ */
+boolean Pwm_IsBlinking(uint8 Timer, uint8 Channel);
+
+#endif /* PWM_H_ */
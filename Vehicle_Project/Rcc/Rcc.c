@@ -54,3 +54,282 @@ void Rcc_Disable(Rcc_PeripheralIdType PeripheralId) {
       break;
   }
 }
+
+/* Last configuration applied by Rcc_ConfigClock */
+static Rcc_ClockConfigType rcc_config;
+static boolean rcc_configured = FALSE;
+
+/* HPRE bits of an AHB divider, 0xFF if the divider does not exist */
+static uint8 Rcc_AhbBits(uint16 Divider) {
+  switch (Divider) {
+    case 1:   return 0x0;
+    case 2:   return 0x8;
+    case 4:   return 0x9;
+    case 8:   return 0xA;
+    case 16:  return 0xB;
+    case 64:  return 0xC;
+    case 128: return 0xD;
+    case 256: return 0xE;
+    case 512: return 0xF;
+    default:  return 0xFF;
+  }
+}
+
+/* PPREx bits of an APB divider, 0xFF if the divider does not exist */
+static uint8 Rcc_ApbBits(uint8 Divider) {
+  switch (Divider) {
+    case 1:  return 0x0;
+    case 2:  return 0x4;
+    case 4:  return 0x5;
+    case 8:  return 0x6;
+    case 16: return 0x7;
+    default: return 0xFF;
+  }
+}
+
+static uint16 Rcc_AhbDivider(uint8 Bits) {
+  static const uint16 dividers[8] = {2, 4, 8, 16, 64, 128, 256, 512};
+  return (Bits < 8) ? 1 : dividers[Bits - 8];
+}
+
+static uint8 Rcc_ApbDivider(uint8 Bits) {
+  return (Bits < 4) ? 1 : (uint8)(2U << (Bits - 4));
+}
+
+/* PLL output, 0 if the PLL factors are out of the limits */
+static uint32 Rcc_PllFreq(uint8 Source, uint8 PllM, uint16 PllN, uint8 PllP) {
+  uint32 input = (Source == RCC_PLL_SRC_HSE) ? RCC_HSE_FREQ : RCC_HSI_FREQ;
+  uint32 vcoInput;
+  uint32 vco;
+
+  if ((PllM < 2) || (PllM > 63) || (PllN < 192) || (PllN > 432) ||
+      (PllP < 2) || (PllP > 8) || ((PllP % 2) != 0)) {
+    return 0;
+  }
+  vcoInput = input / PllM;
+  vco = vcoInput * PllN;
+  if ((vcoInput < 1000000UL) || (vcoInput > 2000000UL) ||
+      (vco < 192000000UL) || (vco > 432000000UL)) {
+    return 0;
+  }
+  return vco / PllP;
+}
+
+/* Wait till a bit of RCC_CR reaches Level */
+static uint8 Rcc_WaitCr(uint8 Bit, uint8 Level) {
+  uint32 count;
+  for (count = 0; count < RCC_TIMEOUT; count++) {
+    if (READ_BIT(RCC_CR, Bit) == Level) {
+      return RCC_OK;
+    }
+  }
+  return RCC_NOK;
+}
+
+/* Switch the system clock and wait till the switch status follows */
+static uint8 Rcc_SwitchSysclk(uint8 Source) {
+  uint32 count;
+  RCC_CFGR = (RCC_CFGR & ~(0x3UL << RCC_CFGR_SW)) | ((uint32)Source << RCC_CFGR_SW);
+  for (count = 0; count < RCC_TIMEOUT; count++) {
+    if (((RCC_CFGR >> RCC_CFGR_SWS) & 0x3UL) == Source) {
+      return RCC_OK;
+    }
+  }
+  return RCC_NOK;
+}
+
+static void Rcc_SetFlashLatency(uint32 Latency) {
+  FLASH_ACR = (FLASH_ACR & ~FLASH_ACR_LATENCY_MASK) | Latency | FLASH_ACR_CACHES;
+}
+
+/* Prescalers fields of RCC_CFGR */
+#define RCC_CFGR_PRESCALERS ((0xFUL << RCC_CFGR_HPRE) | (0x7UL << RCC_CFGR_PPRE1) | (0x7UL << RCC_CFGR_PPRE2))
+
+/* Registers sequence of Rcc_ConfigClock once Config is checked */
+static uint8 Rcc_ApplyClock(const Rcc_ClockConfigType *Config, uint32 Prescalers, uint32 Latency, boolean UseHse) {
+  /* Oscillators of the new clock */
+  SET_BIT(RCC_CR, RCC_CR_HSION);
+  if (Rcc_WaitCr(RCC_CR_HSIRDY, 1) != RCC_OK) {
+    return RCC_NOK;
+  }
+  if (UseHse) {
+    SET_BIT(RCC_CR, RCC_CR_HSEON);
+    if (Rcc_WaitCr(RCC_CR_HSERDY, 1) != RCC_OK) {
+      return RCC_NOK;
+    }
+  }
+
+  /* The PLL can not be changed while it drives the system clock : run on HSI meanwhile */
+  if (((RCC_CFGR >> RCC_CFGR_SWS) & 0x3UL) == RCC_SYSCLK_PLL) {
+    if (Rcc_SwitchSysclk(RCC_SYSCLK_HSI) != RCC_OK) {
+      return RCC_NOK;
+    }
+  }
+  if (Config->SysclkSource == RCC_SYSCLK_PLL) {
+    CLEAR_BIT(RCC_CR, RCC_CR_PLLON);
+    if (Rcc_WaitCr(RCC_CR_PLLRDY, 0) != RCC_OK) {
+      return RCC_NOK;
+    }
+    RCC_PLLCFGR = (uint32)Config->PllM |
+                  ((uint32)Config->PllN << RCC_PLLCFGR_PLLN) |
+                  ((uint32)((Config->PllP / 2) - 1) << RCC_PLLCFGR_PLLP) |
+                  ((uint32)Config->PllSource << RCC_PLLCFGR_PLLSRC) |
+                  ((uint32)Config->PllQ << RCC_PLLCFGR_PLLQ);
+    SET_BIT(RCC_CR, RCC_CR_PLLON);
+    if (Rcc_WaitCr(RCC_CR_PLLRDY, 1) != RCC_OK) {
+      return RCC_NOK;
+    }
+  }
+
+  /* More wait states before a faster HCLK, fewer after a slower one */
+  if (Latency > (FLASH_ACR & FLASH_ACR_LATENCY_MASK)) {
+    Rcc_SetFlashLatency(Latency);
+  }
+  RCC_CFGR = (RCC_CFGR & ~RCC_CFGR_PRESCALERS) | Prescalers;
+  if (Rcc_SwitchSysclk(Config->SysclkSource) != RCC_OK) {
+    return RCC_NOK;
+  }
+  Rcc_SetFlashLatency(Latency);
+
+  /* Unused oscillators off */
+  if (Config->SysclkSource != RCC_SYSCLK_PLL) {
+    CLEAR_BIT(RCC_CR, RCC_CR_PLLON);
+  }
+  if (!UseHse) {
+    CLEAR_BIT(RCC_CR, RCC_CR_HSEON);
+  }
+  return RCC_OK;
+}
+
+/* Back to the clocks saved before a failed Rcc_ApplyClock, through HSI :
+ * the core stays on HSI if the previous clock does not get ready again */
+static void Rcc_RestoreState(uint32 Cr, uint32 Cfgr, uint32 Pllcfgr, uint32 Latency) {
+  uint8 source = (uint8)((Cfgr >> RCC_CFGR_SWS) & 0x3UL);
+  uint8 ready = RCC_OK;
+
+  (void)Rcc_SwitchSysclk(RCC_SYSCLK_HSI);
+  if ((RCC_PLLCFGR != Pllcfgr) || (READ_BIT(RCC_CR, RCC_CR_PLLON) != READ_BIT(Cr, RCC_CR_PLLON))) {
+    CLEAR_BIT(RCC_CR, RCC_CR_PLLON);
+    (void)Rcc_WaitCr(RCC_CR_PLLRDY, 0);
+    RCC_PLLCFGR = Pllcfgr;
+    if (READ_BIT(Cr, RCC_CR_PLLON)) {
+      SET_BIT(RCC_CR, RCC_CR_PLLON);
+      ready = Rcc_WaitCr(RCC_CR_PLLRDY, 1);
+    }
+  }
+  RCC_CFGR = (RCC_CFGR & ~RCC_CFGR_PRESCALERS) | (Cfgr & RCC_CFGR_PRESCALERS);
+  if ((source != RCC_SYSCLK_HSI) && ((source != RCC_SYSCLK_PLL) || (ready == RCC_OK))) {
+    (void)Rcc_SwitchSysclk(source);
+  }
+  if (!READ_BIT(Cr, RCC_CR_HSEON)) {
+    CLEAR_BIT(RCC_CR, RCC_CR_HSEON);
+  }
+  /* the previous wait states fit the previous clock and HSI */
+  Rcc_SetFlashLatency(Latency);
+}
+
+uint8 Rcc_ConfigClock(const Rcc_ClockConfigType *Config) {
+  uint8 hpre;
+  uint8 ppre1;
+  uint8 ppre2;
+  uint32 sysclk;
+  uint32 hclk;
+  uint32 cr;
+  uint32 cfgr;
+  uint32 pllcfgr;
+  uint32 latency;
+  boolean useHse;
+
+  if (Config == 0) {
+    return RCC_NOK;
+  }
+  hpre = Rcc_AhbBits(Config->AhbDivider);
+  ppre1 = Rcc_ApbBits(Config->Apb1Divider);
+  ppre2 = Rcc_ApbBits(Config->Apb2Divider);
+  switch (Config->SysclkSource) {
+    case RCC_SYSCLK_HSI: sysclk = RCC_HSI_FREQ; break;
+    case RCC_SYSCLK_HSE: sysclk = RCC_HSE_FREQ; break;
+    case RCC_SYSCLK_PLL: sysclk = Rcc_PllFreq(Config->PllSource, Config->PllM, Config->PllN, Config->PllP); break;
+    default:             sysclk = 0; break;
+  }
+  if ((sysclk == 0) || (hpre == 0xFF) || (ppre1 == 0xFF) || (ppre2 == 0xFF)) {
+    return RCC_NOK;
+  }
+  hclk = sysclk / Config->AhbDivider;
+  if ((hclk > 84000000UL) || ((hclk / Config->Apb1Divider) > 42000000UL) ||
+      ((hclk / Config->Apb2Divider) > 84000000UL) ||
+      ((Config->SysclkSource == RCC_SYSCLK_PLL) && ((Config->PllQ < 2) || (Config->PllQ > 15)))) {
+    return RCC_NOK;
+  }
+  useHse = ((Config->SysclkSource == RCC_SYSCLK_HSE) ||
+            ((Config->SysclkSource == RCC_SYSCLK_PLL) && (Config->PllSource == RCC_PLL_SRC_HSE))) ? TRUE : FALSE;
+
+  /* Clocks before the change, restored if an oscillator or the PLL does not get ready */
+  cr = RCC_CR;
+  cfgr = RCC_CFGR;
+  pllcfgr = RCC_PLLCFGR;
+  latency = FLASH_ACR & FLASH_ACR_LATENCY_MASK;
+  if (Rcc_ApplyClock(Config, ((uint32)hpre << RCC_CFGR_HPRE) | ((uint32)ppre1 << RCC_CFGR_PPRE1) |
+                     ((uint32)ppre2 << RCC_CFGR_PPRE2), (hclk - 1) / FLASH_WAIT_STATE_FREQ, useHse) != RCC_OK) {
+    Rcc_RestoreState(cr, cfgr, pllcfgr, latency);
+    return RCC_NOK;
+  }
+
+  rcc_config = *Config;
+  rcc_configured = TRUE;
+  return RCC_OK;
+}
+
+void Rcc_RestoreClock(void) {
+  if (rcc_configured) {
+    (void)Rcc_ConfigClock(&rcc_config);
+  }
+}
+
+void Rcc_GetClocks(Rcc_ClocksType *Clocks) {
+  uint32 cfgr = RCC_CFGR;
+  uint32 pllcfgr = RCC_PLLCFGR;
+  uint8 ppre1 = Rcc_ApbDivider((uint8)((cfgr >> RCC_CFGR_PPRE1) & 0x7UL));
+  uint8 ppre2 = Rcc_ApbDivider((uint8)((cfgr >> RCC_CFGR_PPRE2) & 0x7UL));
+
+  if (Clocks == 0) {
+    return;
+  }
+  switch ((cfgr >> RCC_CFGR_SWS) & 0x3UL) {
+    case RCC_SYSCLK_HSE:
+      Clocks->Sysclk = RCC_HSE_FREQ;
+      break;
+    case RCC_SYSCLK_PLL:
+      Clocks->Sysclk = Rcc_PllFreq((uint8)READ_BIT(pllcfgr, RCC_PLLCFGR_PLLSRC), (uint8)(pllcfgr & 0x3FUL),
+                                   (uint16)((pllcfgr >> RCC_PLLCFGR_PLLN) & 0x1FFUL),
+                                   (uint8)((((pllcfgr >> RCC_PLLCFGR_PLLP) & 0x3UL) + 1) * 2));
+      break;
+    default:
+      Clocks->Sysclk = RCC_HSI_FREQ;
+      break;
+  }
+  Clocks->Hclk = Clocks->Sysclk / Rcc_AhbDivider((uint8)((cfgr >> RCC_CFGR_HPRE) & 0xFUL));
+  Clocks->Pclk1 = Clocks->Hclk / ppre1;
+  Clocks->Pclk2 = Clocks->Hclk / ppre2;
+  /* Timers clock is 2 x PCLK when the bus is divided */
+  Clocks->Apb1TimerClk = (ppre1 == 1) ? Clocks->Pclk1 : (2 * Clocks->Pclk1);
+  Clocks->Apb2TimerClk = (ppre2 == 1) ? Clocks->Pclk2 : (2 * Clocks->Pclk2);
+}
+
+uint8 Rcc_StartRtcClock(void) {
+  uint32 count;
+  uint32 rtcsel = (RCC_BDCR >> RCC_BDCR_RTCSEL) & 0x3UL;
+
+  if ((rtcsel != 0) && (rtcsel != RCC_RTCSEL_LSI)) {
+    return RCC_NOK;
+  }
+  SET_BIT(RCC_CSR, RCC_CSR_LSION);
+  for (count = 0; READ_BIT(RCC_CSR, RCC_CSR_LSIRDY) == 0; count++) {
+    if (count == RCC_TIMEOUT) {
+      return RCC_NOK;
+    }
+  }
+  RCC_BDCR = (RCC_BDCR & ~(0x3UL << RCC_BDCR_RTCSEL)) | (RCC_RTCSEL_LSI << RCC_BDCR_RTCSEL);
+  SET_BIT(RCC_BDCR, RCC_BDCR_RTCEN);
+  return RCC_OK;
+}
@@ -53,10 +53,73 @@ typedef uint8 Rcc_PeripheralIdType;
 #define RCC_TIM10           (Rcc_PeripheralIdType)(RCC_APB2*32 + 17UL)
 #define RCC_TIM11           (Rcc_PeripheralIdType)(RCC_APB2*32 + 18UL)
 
+/* Oscillators frequencies (HSE : crystal of the board, LSI : typical value, 17 .. 47 kHz) */
+#define RCC_HSI_FREQ        16000000UL
+#define RCC_HSE_FREQ        8000000UL
+#define RCC_LSI_FREQ        32000UL
+
+/* System clock sources */
+#define RCC_SYSCLK_HSI      0U
+#define RCC_SYSCLK_HSE      1U
+#define RCC_SYSCLK_PLL      2U
+
+/* PLL sources */
+#define RCC_PLL_SRC_HSI     0U
+#define RCC_PLL_SRC_HSE     1U
+
+/* Rcc_ConfigClock status */
+#define RCC_OK              0U
+#define RCC_NOK             1U
+
+/* Clock tree configuration :
+ * SYSCLK = HSI, HSE or PLL = (source / PllM) x PllN / PllP
+ * HCLK = SYSCLK / AhbDivider, PCLK1 = HCLK / Apb1Divider, PCLK2 = HCLK / Apb2Divider
+ * The timers of an APB bus run at 2 x PCLK when the bus is divided.
+ * Limits (STM32F401) : PllM 2..63 (PLL input 1..2 MHz), PllN 192..432, PllP 2/4/6/8,
+ * HCLK <= 84 MHz, PCLK1 <= 42 MHz, PCLK2 <= 84 MHz. */
+typedef struct {
+  uint8 SysclkSource;     /* RCC_SYSCLK_HSI / RCC_SYSCLK_HSE / RCC_SYSCLK_PLL */
+  uint8 PllSource;        /* RCC_PLL_SRC_HSI / RCC_PLL_SRC_HSE */
+  uint8 PllM;
+  uint16 PllN;
+  uint8 PllP;
+  uint8 PllQ;             /* 48 MHz clock divider 2..15 */
+  uint16 AhbDivider;      /* 1, 2, 4, 8, 16, 64, 128, 256, 512 */
+  uint8 Apb1Divider;      /* 1, 2, 4, 8, 16 */
+  uint8 Apb2Divider;      /* 1, 2, 4, 8, 16 */
+} Rcc_ClockConfigType;
+
+/* Bus frequencies in Hz */
+typedef struct {
+  uint32 Sysclk;
+  uint32 Hclk;
+  uint32 Pclk1;
+  uint32 Pclk2;
+  uint32 Apb1TimerClk;    /* TIM2 .. TIM5 */
+  uint32 Apb2TimerClk;    /* TIM1, TIM9 .. TIM11 */
+} Rcc_ClocksType;
+
 void Rcc_Init(void);
 
 void Rcc_Enable(Rcc_PeripheralIdType PeripheralId);
 
 void Rcc_Disable(Rcc_PeripheralIdType PeripheralId);
 
+/* Switch the clock tree to Config (the flash wait states follow HCLK), returns RCC_NOK :
+ * - without changing the clocks if Config is out of the limits,
+ * - with the previous clocks restored if an oscillator / the PLL does not get ready
+ *   (the core stays on HSI if the previous PLL does not get ready again). */
+uint8 Rcc_ConfigClock(const Rcc_ClockConfigType *Config);
+
+/* Apply again the last configuration (the wakeup from Stop mode restarts on HSI) */
+void Rcc_RestoreClock(void);
+
+/* Bus frequencies computed from the RCC registers */
+void Rcc_GetClocks(Rcc_ClocksType *Clocks);
+
+/* Start LSI and clock the RTC with it (it keeps counting in Stop mode), the backup domain must be
+ * writable (PWR_CR DBP). Returns RCC_NOK if LSI does not get ready or the RTC already runs on
+ * another clock (RTCSEL is only changed by a backup domain reset). */
+uint8 Rcc_StartRtcClock(void);
+
 #endif /* RCC_H */
@@ -10,7 +10,15 @@
 #include "Std_Types.h"
 #include "Utils.h"
 
+#ifdef HOST_BACKEND
+#include "Host.h"
+/* Simulated RCC registers of the host backend */
+#define RCC_BASE_ADDR       ((uint8 *)Host_Access(HOST_RCC))
+#define FLASH_BASE_ADDR     ((uint8 *)Host_Access(HOST_FLASH))
+#else
 #define RCC_BASE_ADDR       0x40023800
+#define FLASH_BASE_ADDR     0x40023C00
+#endif
 #define RCC_CR              REG32(RCC_BASE_ADDR, 0x00)
 #define RCC_PLLCFGR         REG32(RCC_BASE_ADDR, 0x04UL)
 #define RCC_CFGR            REG32(RCC_BASE_ADDR, 0x08UL)
@@ -35,5 +43,47 @@
 #define RCC_SSCGR           REG32(RCC_BASE_ADDR, 0x80UL)
 #define RCC_PLLI2SCFGR      REG32(RCC_BASE_ADDR, 0x84UL)
 
+/* Flash access control register (wait states) */
+#define FLASH_ACR           REG32(FLASH_BASE_ADDR, 0x00UL)
+
+/* RCC_CR bits */
+#define RCC_CR_HSION        0
+#define RCC_CR_HSIRDY       1
+#define RCC_CR_HSEON        16
+#define RCC_CR_HSERDY       17
+#define RCC_CR_PLLON        24
+#define RCC_CR_PLLRDY       25
+
+/* RCC_PLLCFGR fields */
+#define RCC_PLLCFGR_PLLN    6
+#define RCC_PLLCFGR_PLLP    16
+#define RCC_PLLCFGR_PLLSRC  22
+#define RCC_PLLCFGR_PLLQ    24
+
+/* RCC_CFGR fields */
+#define RCC_CFGR_SW         0
+#define RCC_CFGR_SWS        2
+#define RCC_CFGR_HPRE       4
+#define RCC_CFGR_PPRE1      10
+#define RCC_CFGR_PPRE2      13
+
+/* RCC_BDCR fields */
+#define RCC_BDCR_RTCSEL     8
+#define RCC_BDCR_RTCEN      15
+#define RCC_RTCSEL_LSI      2UL
+
+/* RCC_CSR bits */
+#define RCC_CSR_LSION       0
+#define RCC_CSR_LSIRDY      1
+
+/* Flash wait states : one per 30 MHz of HCLK (2.7 V .. 3.6 V) */
+#define FLASH_ACR_LATENCY_MASK  0x0FUL
+#define FLASH_WAIT_STATE_FREQ   30000000UL
+/* Prefetch, instruction cache and data cache enable */
+#define FLASH_ACR_CACHES        ((1UL << 8) | (1UL << 9) | (1UL << 10))
+
+/* Polling loops on the ready bits */
+#define RCC_TIMEOUT         100000UL
+
 
 #endif /* RCC_PRIVATE_H */
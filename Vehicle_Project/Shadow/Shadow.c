@@ -0,0 +1,114 @@
+/* *****************************************************************************
+ * Module: Shadow
+ *
+ * File Name: Shadow.c
+ *
+ * Description: Source file for the output shadow layer over the GPIO driver
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "Shadow.h"
+#include "Gpio.h"
+
+
+/*******************************************************************************
+ *                      Global Variables   	                                   *
+ *******************************************************************************/
+
+/* Shadow image and controlled pins of each port */
+static uint16 shadow_image[NUM_OF_PORTS];
+static uint16 shadow_pins[NUM_OF_PORTS];
+
+static Shadow_StatsType shadow_stats;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : Shadow_Init
+ * Input : PortName, PinsMask, InitialImage
+ * Output : void
+ * Description :
+ * Write the InitialImage levels of the pins of PinsMask to the port and load them in the shadow image.
+ * Pins of the port outside PinsMask are never written by the shadow layer.
+ */
+void Shadow_Init(uint8 PortName, uint16 PinsMask, uint16 InitialImage){
+	if (PortName >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		shadow_pins[PortName] = PinsMask;
+		shadow_image[PortName] = InitialImage & PinsMask;
+		/* First write is always committed to put the port in a known state */
+		Gpio_WritePortMasked(PortName, InitialImage & PinsMask, (uint16)(~InitialImage) & PinsMask);
+		shadow_stats.CommittedWrites++;
+	}
+}
+
+/*
+ * Function : Shadow_WriteMasked
+ * Input : PortName, SetMask, ClearMask
+ * Output : void
+ * Description :
+ * Set the pins of SetMask and clear the pins of ClearMask in the shadow image,
+ * only the pins that changed are written to the port with one Gpio_WritePortMasked call.
+ */
+void Shadow_WriteMasked(uint8 PortName, uint16 SetMask, uint16 ClearMask){
+	if (PortName >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		uint16 oldImage = shadow_image[PortName];
+		/* Set has priority over clear as in BSRR Register */
+		uint16 newImage = (uint16)(((oldImage & ~ClearMask) | SetMask) & shadow_pins[PortName]);
+		uint16 changedPins = oldImage ^ newImage;
+
+		if (changedPins == 0)
+		{
+			/* Same levels as the port : nothing to write */
+			shadow_stats.SuppressedWrites++;
+		}
+		else
+		{
+			shadow_image[PortName] = newImage;
+			Gpio_WritePortMasked(PortName, newImage & changedPins, oldImage & changedPins);
+			shadow_stats.CommittedWrites++;
+		}
+	}
+}
+
+/*
+ * Function : Shadow_GetImage
+ * Input : PortName
+ * Output : uint16 image of the output pins of the port
+ * Description :
+ * Return the last written levels of the pins of the port from RAM.
+ */
+uint16 Shadow_GetImage(uint8 PortName){
+	if (PortName >= NUM_OF_PORTS)
+	{
+		return 0;
+	}
+	return shadow_image[PortName];
+}
+
+/*
+ * Function : Shadow_GetStats
+ * Input : Stats
+ * Output : void
+ * Description :
+ * Copy the committed and suppressed writes counters of all ports to Stats.
+ */
+void Shadow_GetStats(Shadow_StatsType * Stats){
+	if (Stats != 0)
+	{
+		*Stats = shadow_stats;
+	}
+}
@@ -0,0 +1,92 @@
+/* *****************************************************************************
+ * Module: Shadow
+ *
+ * File Name: Shadow.h
+ *
+ * Description: Header file for the output shadow layer over the GPIO driver
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef SHADOW_H_
+#define SHADOW_H_
+
+#include "Std_Types.h"
+#include "Gpio.h"
+#include "Gpio_Pin.h"
+
+/* Shadow Documentation */
+/* Output Shadow Layer over the GPIO driver
+ * The desired level of the output pins of each port is kept in RAM (the shadow image),
+ * the port is written only when a write really changes a bit of the image.
+ * 1. Take control of output pins of a port by calling Shadow_Init() with their initial levels.
+ * 2. Write pins by calling Shadow_WriteMasked() or SHADOW_PIN_WRITE() as often as needed.
+ * 3. Read the image by calling Shadow_GetImage() without any access to the port.
+ * 4. Read the committed / suppressed writes counters by calling Shadow_GetStats().
+ * The layer is not reentrant : all writes of one port must be done from the same context.
+ *  */
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct {
+	uint32 CommittedWrites;   /* writes that changed the image and were stored to the port */
+	uint32 SuppressedWrites;  /* writes that did not change the image and were dropped */
+} Shadow_StatsType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : Shadow_Init
+ * Input : PortName, PinsMask, InitialImage
+ * Output : void
+ * Description :
+ * Write the InitialImage levels of the pins of PinsMask to the port and load them in the shadow image.
+ * Pins of the port outside PinsMask are never written by the shadow layer.
+ */
+void Shadow_Init(uint8 PortName, uint16 PinsMask, uint16 InitialImage);
+
+/*
+ * Function : Shadow_WriteMasked
+ * Input : PortName, SetMask, ClearMask
+ * Output : void
+ * Description :
+ * Set the pins of SetMask and clear the pins of ClearMask in the shadow image,
+ * only the pins that changed are written to the port with one Gpio_WritePortMasked call.
+ */
+void Shadow_WriteMasked(uint8 PortName, uint16 SetMask, uint16 ClearMask);
+
+/*
+ * Function : Shadow_GetImage
+ * Input : PortName
+ * Output : uint16 image of the output pins of the port
+ * Description :
+ * Return the last written levels of the pins of the port from RAM.
+ */
+uint16 Shadow_GetImage(uint8 PortName);
+
+/*
+ * Function : Shadow_GetStats
+ * Input : Stats
+ * Output : void
+ * Description :
+ * Copy the committed and suppressed writes counters of all ports to Stats.
+ */
+void Shadow_GetStats(Shadow_StatsType * Stats);
+
+/*
+ * Macro : SHADOW_PIN_WRITE
+ * Input : HANDLE, Data
+ * Description :
+ * Write Data to an output pin handle through the shadow image.
+ */
+#define SHADOW_PIN_WRITE(HANDLE, Data) \
+	(GPIO_HANDLE_CHECK(HANDLE, GPIO_OUTPUT), \
+	 Shadow_WriteMasked(GPIO_HANDLE_PORT(HANDLE), (Data) ? GPIO_HANDLE_MASK(HANDLE) : 0, \
+	                    (Data) ? 0 : GPIO_HANDLE_MASK(HANDLE)))
+
+#endif /* SHADOW_H_ */
@@ -0,0 +1,311 @@
+/* *****************************************************************************
+ * Module: SwTimer
+ *
+ * File Name: SwTimer.c
+ *
+ * Description: Source file for the software timers service over the GPT monotonic clock (TIM5)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#include "SwTimer.h"
+#include "GPT.h"
+#include "NVIC.h"
+#include "Power.h"
+
+
+/*******************************************************************************
+ *                      Macros & Global Variables                              *
+ *******************************************************************************/
+
+#define SWTIMER_NOT_IN_HEAP 0xFF
+
+/* State of one software timer */
+typedef struct {
+	uint64 Deadline;                 /* clock ticks of the next expiry */
+	uint64 Period;                   /* 0 : one-shot */
+	SwTimer_CallbackType Callback;
+	uint8 HeapIndex;                 /* position in the heap, SWTIMER_NOT_IN_HEAP : stopped */
+	boolean Expired;
+} SwTimer_Type;
+
+static SwTimer_Type swtimer[SWTIMER_MAX_TIMERS];
+
+/* Min-heap of the running timers ids ordered by deadline */
+static uint8 swtimer_heap[SWTIMER_MAX_TIMERS];
+static uint8 swtimer_heap_size;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/* Deadline of timer A is before the deadline of timer B */
+static boolean SwTimer_IsBefore(uint8 TimerA, uint8 TimerB)
+{
+	return (swtimer[TimerA].Deadline < swtimer[TimerB].Deadline) ? TRUE : FALSE;
+}
+
+static void SwTimer_HeapPlace(uint8 Index, uint8 TimerId)
+{
+	swtimer_heap[Index] = TimerId;
+	swtimer[TimerId].HeapIndex = Index;
+}
+
+static void SwTimer_SiftUp(uint8 Index)
+{
+	uint8 timerId = swtimer_heap[Index];
+
+	while (Index > 0)
+	{
+		uint8 parent = (Index - 1) / 2;
+		if (SwTimer_IsBefore(timerId, swtimer_heap[parent]) == FALSE)
+		{
+			break;
+		}
+		SwTimer_HeapPlace(Index, swtimer_heap[parent]);
+		Index = parent;
+	}
+	SwTimer_HeapPlace(Index, timerId);
+}
+
+static void SwTimer_SiftDown(uint8 Index)
+{
+	uint8 timerId = swtimer_heap[Index];
+
+	while (1)
+	{
+		uint8 child = (2 * Index) + 1;
+		if (child >= swtimer_heap_size)
+		{
+			break;
+		}
+		if (((child + 1) < swtimer_heap_size) && SwTimer_IsBefore(swtimer_heap[child + 1], swtimer_heap[child]))
+		{
+			child++;
+		}
+		if (SwTimer_IsBefore(swtimer_heap[child], timerId) == FALSE)
+		{
+			break;
+		}
+		SwTimer_HeapPlace(Index, swtimer_heap[child]);
+		Index = child;
+	}
+	SwTimer_HeapPlace(Index, timerId);
+}
+
+static void SwTimer_HeapInsert(uint8 TimerId)
+{
+	SwTimer_HeapPlace(swtimer_heap_size, TimerId);
+	swtimer_heap_size++;
+	SwTimer_SiftUp(swtimer_heap_size - 1);
+}
+
+static void SwTimer_HeapRemove(uint8 TimerId)
+{
+	uint8 index = swtimer[TimerId].HeapIndex;
+
+	if (index == SWTIMER_NOT_IN_HEAP)
+	{
+		return;
+	}
+	swtimer[TimerId].HeapIndex = SWTIMER_NOT_IN_HEAP;
+	swtimer_heap_size--;
+	if (index != swtimer_heap_size)
+	{
+		/* Move the last timer to the free position */
+		uint8 lastId = swtimer_heap[swtimer_heap_size];
+		SwTimer_HeapPlace(index, lastId);
+		SwTimer_SiftUp(index);
+		SwTimer_SiftDown(swtimer[lastId].HeapIndex);
+	}
+}
+
+/* Block the alarm while the heap is changed */
+static void SwTimer_Lock(void)
+{
+	GPT_ClockCancelAlarm();
+}
+
+/* Program the alarm with the nearest deadline (no alarm when no timer is running) */
+static void SwTimer_Program(void)
+{
+	if (swtimer_heap_size != 0)
+	{
+		GPT_ClockSetAlarm(swtimer[swtimer_heap[0]].Deadline);
+	}
+}
+
+/* Alarm callback : expire all the timers whose deadline is reached */
+static void SwTimer_ProcessExpired(void)
+{
+	uint64 now = GPT_GetTicks64();
+
+	while ((swtimer_heap_size > 0) && (swtimer[swtimer_heap[0]].Deadline <= now))
+	{
+		uint8 timerId = swtimer_heap[0];
+		SwTimer_Type * timer = &swtimer[timerId];
+
+		SwTimer_HeapRemove(timerId);
+		if (timer->Period != 0)
+		{
+			/* Periodic timer : next deadline from the previous one, no drift */
+			timer->Deadline += timer->Period;
+			SwTimer_HeapInsert(timerId);
+		}
+		timer->Expired = TRUE;
+		/* the main loop polls the expiries : end its idle */
+		Power_Wakeup();
+		if (timer->Callback != 0)
+		{
+			timer->Callback(timerId);
+		}
+	}
+	SwTimer_Program();
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Function : SwTimer_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Stop all the software timers and take the alarm of the GPT clock.
+ */
+void SwTimer_Init(void){
+	uint8 index;
+
+	for (index = 0; index < SWTIMER_MAX_TIMERS; index++)
+	{
+		swtimer[index].HeapIndex = SWTIMER_NOT_IN_HEAP;
+		swtimer[index].Expired = FALSE;
+		swtimer[index].Callback = 0;
+	}
+	swtimer_heap_size = 0;
+
+	GPT_ClockCancelAlarm();
+	GPT_ClockSetAlarmCallback(SwTimer_ProcessExpired);
+}
+
+/*
+ * Function : SwTimer_Start
+ * Input : TimerId, TimeMs, PeriodMs, Callback
+ * Output : void
+ * Description :
+ * Start (or restart) the timer to expire after TimeMs, then every PeriodMs if PeriodMs is not 0.
+ * Callback can be 0 when the expiry is polled with SwTimer_CheckExpired.
+ * A pending expiry of the previous run is dropped.
+ *  If the input timer id is not correct, The function will not handle the request.
+ */
+void SwTimer_Start(uint8 TimerId, uint32 TimeMs, uint32 PeriodMs, SwTimer_CallbackType Callback){
+	SwTimer_Type * timer;
+
+	if (TimerId >= SWTIMER_MAX_TIMERS)
+	{
+		return;
+	}
+	timer = &swtimer[TimerId];
+
+	SwTimer_Lock();
+	SwTimer_HeapRemove(TimerId);
+	timer->Deadline = GPT_GetTicks64() + ((uint64)TimeMs * GPT_CLOCK_TICKS_PER_MS);
+	timer->Period = (uint64)PeriodMs * GPT_CLOCK_TICKS_PER_MS;
+	timer->Callback = Callback;
+	timer->Expired = FALSE;
+	SwTimer_HeapInsert(TimerId);
+	SwTimer_Program();
+}
+
+/*
+ * Function : SwTimer_Stop
+ * Input : TimerId
+ * Output : void
+ * Description :
+ * Stop the timer and drop its pending expiry.
+ */
+void SwTimer_Stop(uint8 TimerId){
+	if (TimerId >= SWTIMER_MAX_TIMERS)
+	{
+		return;
+	}
+	SwTimer_Lock();
+	SwTimer_HeapRemove(TimerId);
+	swtimer[TimerId].Expired = FALSE;
+	SwTimer_Program();
+}
+
+/*
+ * Function : SwTimer_IsRunning
+ * Input : TimerId
+ * Output : TRUE if the timer is waiting for an expiry, FALSE otherwise
+ */
+boolean SwTimer_IsRunning(uint8 TimerId){
+	if (TimerId >= SWTIMER_MAX_TIMERS)
+	{
+		return FALSE;
+	}
+	return (swtimer[TimerId].HeapIndex != SWTIMER_NOT_IN_HEAP) ? TRUE : FALSE;
+}
+
+/*
+ * Function : SwTimer_GetRunningCount
+ * Input : void
+ * Output : uint8 number of timers waiting for an expiry
+ */
+uint8 SwTimer_GetRunningCount(void){
+	return swtimer_heap_size;
+}
+
+/*
+ * Function : SwTimer_CheckExpired
+ * Input : TimerId
+ * Output : TRUE if the timer expired since the last call, FALSE otherwise
+ * Description :
+ * Read and clear the expiry flag of the timer.
+ */
+boolean SwTimer_CheckExpired(uint8 TimerId){
+	boolean expired;
+	uint32 saved;
+
+	if (TimerId >= SWTIMER_MAX_TIMERS)
+	{
+		return FALSE;
+	}
+	/* only the flag is shared with the alarm interrupt : hold it, the alarm stays programmed */
+	saved = Nvic_EnterCritical(SWTIMER_ALARM_PRIORITY);
+	expired = swtimer[TimerId].Expired;
+	swtimer[TimerId].Expired = FALSE;
+	Nvic_ExitCritical(saved);
+	return expired;
+}
+
+/*
+ * Function : SwTimer_GetRemainingTime
+ * Input : TimerId
+ * Output : uint32 ms till the next expiry of the timer, 0 if it is not running
+ */
+uint32 SwTimer_GetRemainingTime(uint8 TimerId){
+	uint64 deadline;
+	uint64 now;
+
+	if (SwTimer_IsRunning(TimerId) == FALSE)
+	{
+		return 0;
+	}
+	deadline = swtimer[TimerId].Deadline;
+	now = GPT_GetTicks64();
+	/* rounded up to a whole ms */
+	return (deadline > now) ? (uint32)((deadline - now + GPT_CLOCK_TICKS_PER_MS - 1) / GPT_CLOCK_TICKS_PER_MS) : 0;
+}
+
+/*
+ * Function : SwTimer_GetTime
+ * Input : void
+ * Output : uint32 ms of the GPT clock (wraps after 49 days)
+ */
+uint32 SwTimer_GetTime(void){
+	return (uint32)GPT_GetTimeMs64();
+}
@@ -0,0 +1,121 @@
+/* *****************************************************************************
+ * Module: SwTimer
+ *
+ * File Name: SwTimer.h
+ *
+ * Description: Header file for the software timers service over the GPT monotonic clock (TIM5)
+ *
+ * Author: Omar Saad
+ *
+ *******************************************************************************/
+
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+#include "Std_Types.h"
+
+/* Software Timers Documentation */
+/* N independent one-shot / periodic timers multiplexed on the GPT monotonic clock
+ * The running timers are kept in a min-heap ordered by deadline (64-bit clock ticks)
+ * and the clock alarm (TIM5 compare channel 1) is programmed with the nearest deadline only.
+ * 1. Start the clock by calling GPT_ClockInit(), then initialize the service by calling SwTimer_Init().
+ * 2. Start a timer by calling SwTimer_Start( id, time in ms, period in ms, callback ),
+ *    a period of 0 gives a one-shot timer, a running timer is restarted.
+ * 3. Check the expiry of a timer by calling SwTimer_CheckExpired( id ) from the polling loop,
+ *    or give a callback, it is called from the TIM5 interrupt at the expiry.
+ * 4. Stop a timer by calling SwTimer_Stop( id ).
+ * Start and Stop are O(log n), an expiry is O(log n), the interrupt only runs at the deadlines.
+ * The timer ids are chosen by the application (0 .. SWTIMER_MAX_TIMERS - 1).
+ * Each expiry calls Power_Wakeup(), the main loop can idle till the next deadline.
+ *  */
+
+/*******************************************************************************
+ *                         Static Configuration                                *
+ *******************************************************************************/
+
+/* Number of software timers */
+#define SWTIMER_MAX_TIMERS 8
+
+/* Preemption priority of the TIM5 interrupt (alarm) : SwTimer_CheckExpired holds it while it reads
+ * and clears an expiry flag */
+#define SWTIMER_ALARM_PRIORITY 2
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Expiry callback, called from the TIM5 interrupt with the id of the expired timer */
+typedef void (*SwTimer_CallbackType)(uint8 TimerId);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Function : SwTimer_Init
+ * Input : void
+ * Output : void
+ * Description :
+ * Stop all the software timers and take the alarm of the GPT clock.
+ */
+void SwTimer_Init(void);
+
+/*
+ * Function : SwTimer_Start
+ * Input : TimerId, TimeMs, PeriodMs, Callback
+ * Output : void
+ * Description :
+ * Start (or restart) the timer to expire after TimeMs, then every PeriodMs if PeriodMs is not 0.
+ * Callback can be 0 when the expiry is polled with SwTimer_CheckExpired.
+ * A pending expiry of the previous run is dropped.
+ *  If the input timer id is not correct, The function will not handle the request.
+ */
+void SwTimer_Start(uint8 TimerId, uint32 TimeMs, uint32 PeriodMs, SwTimer_CallbackType Callback);
+
+/*
+ * Function : SwTimer_Stop
+ * Input : TimerId
+ * Output : void
+ * Description :
+ * Stop the timer and drop its pending expiry.
+ */
+void SwTimer_Stop(uint8 TimerId);
+
+/*
+ * Function : SwTimer_IsRunning
+ * Input : TimerId
+ * Output : TRUE if the timer is waiting for an expiry, FALSE otherwise
+ */
+boolean SwTimer_IsRunning(uint8 TimerId);
+
+/*
+ * Function : SwTimer_GetRunningCount
+ * Input : void
+ * Output : uint8 number of timers waiting for an expiry
+ */
+uint8 SwTimer_GetRunningCount(void);
+
+/*
+ * Function : SwTimer_CheckExpired
+ * Input : TimerId
+ * Output : TRUE if the timer expired since the last call, FALSE otherwise
+ * Description :
+ * Read and clear the expiry flag of the timer.
+ */
+boolean SwTimer_CheckExpired(uint8 TimerId);
+
+/*
+ * Function : SwTimer_GetRemainingTime
+ * Input : TimerId
+ * Output : uint32 ms till the next expiry of the timer, 0 if it is not running
+ */
+uint32 SwTimer_GetRemainingTime(uint8 TimerId);
+
+/*
+ * Function : SwTimer_GetTime
+ * Input : void
+ * Output : uint32 ms of the GPT clock (wraps after 49 days)
+ */
+uint32 SwTimer_GetTime(void);
+
+#endif /* SWTIMER_H_ */
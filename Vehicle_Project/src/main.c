@@ -8,12 +8,21 @@
 
 // #include "GPT.h"
 #include "Gpio.h"
+#include "Gpio_Pin.h"
+#include "Shadow.h"
+#include "Pwm.h"
 #include "Rcc.h"
-#include "Rcc_Private.h"
 
 #include "Std_Types.h"
 #include "GPT.h"
+#include "SwTimer.h"
 #include "NVIC.h"
+#include "Power.h"
+#include "Debounce.h"
+#include "EventQueue.h"
+#include "Latency.h"
+#include "Fsm.h"
+#include "Pattern.h"
 
 
 /*******************************************************************************
@@ -29,6 +38,33 @@
 #define HAZARD_LIGHT_LED 6
 #define AMBIENT_LIGHT_LED 7
 
+/* LEDs Pin Handles on GPIO_B */
+#define VEHICLE_LOCK_LED_PIN   GPIO_PIN_HANDLE(GPIO_B, VEHICLE_LOCK_LED, GPIO_OUTPUT)
+/* Hazard Light LED is blinked by TIM4 Channel 1 in toggle on match mode (PB6 alternate function 2) */
+#define HAZARD_LIGHT_LED_PIN   GPIO_PIN_HANDLE(GPIO_B, HAZARD_LIGHT_LED, GPIO_AF)
+#define HAZARD_LIGHT_TIMER     PWM_TIM4
+#define HAZARD_LIGHT_CHANNEL   PWM_CHANNEL_1
+/* Ambient Light LED is dimmed by TIM4 Channel 2 (PB7 alternate function 2) */
+#define AMBIENT_LIGHT_LED_PIN  GPIO_PIN_HANDLE(GPIO_B, AMBIENT_LIGHT_LED, GPIO_AF)
+#define AMBIENT_LIGHT_TIMER    PWM_TIM4
+#define AMBIENT_LIGHT_CHANNEL  PWM_CHANNEL_2
+
+/* LEDs Masks on GPIO_B */
+#define VEHICLE_LOCK_LED_MASK  GPIO_HANDLE_MASK(VEHICLE_LOCK_LED_PIN)
+#define AMBIENT_LIGHT_LED_MASK GPIO_HANDLE_MASK(AMBIENT_LIGHT_LED_PIN)
+#define ALL_LEDS_MASK          VEHICLE_LOCK_LED_MASK
+
+/* Hazard Light blinking ( 0.5 sec high and 0.5 sec low for each blink ), edges generated by the timer */
+#define HAZARD_LIGHT_BLINK(BLINKS)  Pwm_StartBlink(HAZARD_LIGHT_TIMER, HAZARD_LIGHT_CHANNEL, HAZARD_HALF_PERIOD, HAZARD_HALF_PERIOD, BLINKS)
+#define HAZARD_LIGHT_OFF()          Pwm_StopBlink(HAZARD_LIGHT_TIMER, HAZARD_LIGHT_CHANNEL)
+
+/* Ambient Light welcome (fade in) and farewell (fade out) effects, the fade out ends a light time
+ * (it must be shorter than CLOSING_LIGHT_TIME) */
+#define AMBIENT_FADE_IN_MS     500
+#define AMBIENT_FADE_OUT_MS    500
+#define AMBIENT_LIGHT_ON()     Pwm_StartFade(AMBIENT_LIGHT_TIMER, AMBIENT_LIGHT_CHANNEL, PWM_DUTY_MAX, AMBIENT_FADE_IN_MS)
+#define AMBIENT_LIGHT_OFF()    Pwm_StartFade(AMBIENT_LIGHT_TIMER, AMBIENT_LIGHT_CHANNEL, PWM_DUTY_OFF, AMBIENT_FADE_OUT_MS)
+
 /* Active High Led States*/
 #define BUTTON_PRESSED LOW
 #define BUTTON_RELEASED HIGH
@@ -37,13 +73,19 @@
 #define LED_ON HIGH
 #define LED_OFF LOW
 
-/* USE CASES*/
+/* USE CASES (states of the door state machine)*/
 #define DEFAULT_STATE 0
 #define DOOR_UNLOCK 1
 #define DOOR_IS_OPEN 2
 #define ANTI_THEFT_LOCK 3
 #define CLOSING_THE_DOOR 4
 #define LOCKING_THE_DOOR 5
+#define NUM_OF_USE_CASES 6
+
+/* Events of the door state machine */
+#define HANDLE_PRESSED    0
+#define DOOR_PRESSED      1
+#define STATE_TIME_OUT    2
 
 /* DOOR status*/
 #define DOOR_LOCKED LOW
@@ -55,27 +97,357 @@
 #define STARTED 1
 #define ENDED 0
 
+/* Interrupts preemption priorities (0 : highest) : the lights timer keeps exact edges,
+ * the clock keeps the software timers on time, the buttons (EXTI lines and debounce timer) run last */
+#define LIGHTS_IRQ_PRIORITY   1   /* TIM4 : hazard blink and ambient fade */
+#define CLOCK_IRQ_PRIORITY    2   /* TIM5 : monotonic clock and software timers (EVENTQUEUE_PRODUCER_PRIORITY, SWTIMER_ALARM_PRIORITY) */
+#define BUTTONS_IRQ_PRIORITY  3   /* EXTI2, EXTI3 and TIM2 : push buttons debounce */
+
+/* Latency probes (core cycles) */
+#define PROBE_BUTTON_EDGE      0   /* EXTI handler of a button edge */
+#define PROBE_BUTTON_REACTION  1   /* confirmed button level to the end of its handling */
+#define PROBE_TIMER_REACTION   2   /* software timer expiry to the end of its handling */
+#define PROBE_DEBOUNCE_TIMER   3   /* TIM2 handler : debounce timer */
+#define PROBE_LIGHTS_TIMER     4   /* TIM4 handler : hazard blink and ambient fade */
+#define PROBE_CLOCK_TIMER      5   /* TIM5 handler : monotonic clock and software timers */
+
+/* Software Timers (PATTERN_FIRST_TIMER .. : LED patterns) */
+#define STATE_TIMER   0   /* time out of the current use case */
+
+/* LED patterns slots */
+#define AMBIENT_PATTERN  0
+
+/* Times in ms */
+#define BUTTON_DEBOUNCE_MS  20
+#define UNLOCK_TIME_OUT     10000
+#define CLOSING_TIME_OUT    10000
+#define BLINKING_TIME       2000
+#define HAZARD_HALF_PERIOD  500
+#define WELCOME_LIGHT_TIME  2000
+#define CLOSING_LIGHT_TIME  1000
+
 /*******************************************************************************
  *                            Global Variables                                 *
  *******************************************************************************/
-uint8 use_case = DEFAULT_STATE;
+/* Clock tree : HSI 16 MHz / 16 x 336 / 4 = 84 MHz core, APB1 42 MHz (timers 84 MHz), APB2 84 MHz */
+const Rcc_ClockConfigType clock_config = {
+	.SysclkSource = RCC_SYSCLK_PLL,
+	.PllSource = RCC_PLL_SRC_HSI,
+	.PllM = 16,
+	.PllN = 336,
+	.PllP = 4,
+	.PllQ = 7,
+	.AhbDivider = 1,
+	.Apb1Divider = 2,
+	.Apb2Divider = 1,
+};
+
+/* LEDs Pins Configuration Table of GPIO_B */
+const Gpio_PinConfigType leds_config[] = {
+	GPIO_PIN_CONFIG_ENTRY(VEHICLE_LOCK_LED_PIN, GPIO_PUSH_PULL, GPIO_NO_PULL, GPIO_SPEED_LOW, GPIO_AF0),
+	GPIO_PIN_CONFIG_ENTRY(HAZARD_LIGHT_LED_PIN, GPIO_PUSH_PULL, GPIO_NO_PULL, GPIO_SPEED_LOW, GPIO_AF2),
+	GPIO_PIN_CONFIG_ENTRY(AMBIENT_LIGHT_LED_PIN, GPIO_PUSH_PULL, GPIO_NO_PULL, GPIO_SPEED_LOW, GPIO_AF2),
+};
+
+/* Ambient Light patterns : ON (fade in), then OFF (fade out) started AMBIENT_FADE_OUT_MS before the end
+ * of the light time, so the light is dark at the light time as with the ON / OFF output */
+static const Pattern_StepType welcome_light_steps[] = {
+	/* LEDs                  Levels                  Duration */
+	{ AMBIENT_LIGHT_LED_MASK, AMBIENT_LIGHT_LED_MASK, WELCOME_LIGHT_TIME - AMBIENT_FADE_OUT_MS },
+	{ AMBIENT_LIGHT_LED_MASK, 0,                      0 },
+};
+static const Pattern_StepType closing_light_steps[] = {
+	{ AMBIENT_LIGHT_LED_MASK, AMBIENT_LIGHT_LED_MASK, CLOSING_LIGHT_TIME - AMBIENT_FADE_OUT_MS },
+	{ AMBIENT_LIGHT_LED_MASK, 0,                      0 },
+};
+static const Pattern_Type welcome_light = { welcome_light_steps, sizeof(welcome_light_steps) / sizeof(welcome_light_steps[0]) };
+static const Pattern_Type closing_light = { closing_light_steps, sizeof(closing_light_steps) / sizeof(closing_light_steps[0]) };
 
 uint8 handle_lock = DOOR_LOCKED;
 uint8 door_lock = DOOR_CLOSED;
 
-extern unsigned long int g_overflow_flag;
+/*******************************************************************************
+ *                            Push Buttons                                     *
+ *******************************************************************************/
+
+/* Post an event to the main loop (from the interrupts) */
+static void Post_Event(uint8 Type, uint8 Id, uint8 Level)
+{
+	EventQueue_EventType event;
+
+	event.Timestamp = (uint32)GPT_GetTicks64();
+	event.Type = Type;
+	event.Id = Id;
+	event.Level = Level;
+	(void)EventQueue_Post(&event);
+}
+
+/* Edge of a button, from its EXTI interrupt */
+static void Buttons_Edge(uint8 LineNum)
+{
+	Latency_Start(PROBE_BUTTON_EDGE);
+	Debounce_OnEdge(LineNum);
+	Latency_Stop(PROBE_BUTTON_EDGE);
+}
+
+/* Confirmed level of a button (debounced), from the debounce timer interrupt */
+static void Buttons_Debounced(uint8 LineNum, uint8 Level)
+{
+	Latency_Start(PROBE_BUTTON_REACTION);
+	Post_Event(EVENTQUEUE_BUTTON, LineNum, Level);
+}
+
+/* Expiry of a software timer, from the clock interrupt */
+static void Timers_Expired(uint8 TimerId)
+{
+	Latency_Start(PROBE_TIMER_REACTION);
+	Post_Event(EVENTQUEUE_TIMER, TimerId, 0);
+}
+
+/* A press toggles the state of the button (main loop) */
+static void Buttons_Pressed(uint8 LineNum)
+{
+	if (LineNum == HANDLE_LOCK_BUTTON)
+	{
+		/* Handle Lock Button */
+		handle_lock = !handle_lock;
+	}
+	else if (LineNum == DOOR_LOCK_BUTTON)
+	{
+		/* Door Lock Button */
+		if (handle_lock == DOOR_UNLOCKED){
+			door_lock = !door_lock;
+		}
+		else if( (handle_lock == DOOR_LOCKED) && (door_lock == DOOR_OPENED ) ){
+			door_lock = !door_lock;
+		}
+	}
+}
+
+/*******************************************************************************
+ *                            LEDs Patterns                                    *
+ *******************************************************************************/
+
+/* Levels of a pattern step : the ambient light fades, the other LEDs are shadowed pins */
+static void Leds_Output(uint16 Mask, uint16 Level)
+{
+	if ((Mask & AMBIENT_LIGHT_LED_MASK) != 0)
+	{
+		if ((Level & AMBIENT_LIGHT_LED_MASK) != 0)
+		{
+			AMBIENT_LIGHT_ON();
+		}
+		else
+		{
+			AMBIENT_LIGHT_OFF();
+		}
+	}
+	if ((Mask & ALL_LEDS_MASK) != 0)
+	{
+		Shadow_WriteMasked(GPIO_B, Level & ALL_LEDS_MASK, Mask & ~Level & ALL_LEDS_MASK);
+	}
+}
+
+/*******************************************************************************
+ *                            Door State Machine                               *
+ *******************************************************************************/
+
+/* Buttons conditions */
+static boolean Handle_IsLocked(void)   { return (handle_lock == DOOR_LOCKED) ? TRUE : FALSE; }
+static boolean Handle_IsUnlocked(void) { return (handle_lock == DOOR_UNLOCKED) ? TRUE : FALSE; }
+static boolean Door_IsOpened(void)     { return (door_lock == DOOR_OPENED) ? TRUE : FALSE; }
+static boolean Door_IsClosed(void)     { return (door_lock == DOOR_CLOSED) ? TRUE : FALSE; }
+
+/* Exit of every use case : its timer, the ambient light pattern and the hazard light are stopped */
+static void Use_Case_Exit(void)
+{
+	SwTimer_Stop(STATE_TIMER);
+	Pattern_Stop(AMBIENT_PATTERN);
+	HAZARD_LIGHT_OFF();
+}
+
+/* System is Powered ON, No Buttons is pressed : All LEDs are OFF */
+static void Default_Entry(void)
+{
+	Shadow_WriteMasked(GPIO_B, 0, ALL_LEDS_MASK);
+	AMBIENT_LIGHT_OFF();
+}
+
+/* Vehicle Door Unlocked but still Closed */
+static void Door_Unlock_Entry(void)
+{
+	/* Vehicle Lock LED is ON*/
+	SHADOW_PIN_WRITE(VEHICLE_LOCK_LED_PIN, HIGH);
+	/*HAZARD LED is Blinking for one time ( 0.5 sec high and 0.5 sec low ) */
+	HAZARD_LIGHT_BLINK(1);
+	/* Ambient Light Led is on for 2 seconds */
+	Pattern_Start(AMBIENT_PATTERN, &welcome_light);
+	/* Start counting for 10 seconds If no buttons is pressed go to ANTI_THEFT_LOCK state */
+	SwTimer_Start(STATE_TIMER, UNLOCK_TIME_OUT, 0, Timers_Expired);
+}
+
+/* Vehicle Door Unlocked and Door is Open : Ambient LED and Vehicle Lock LED are ON, Hazard LED is OFF */
+static void Door_Is_Open_Entry(void)
+{
+	SHADOW_PIN_WRITE(VEHICLE_LOCK_LED_PIN, HIGH);
+	AMBIENT_LIGHT_ON();
+}
+
+/* Anti theft lock and door locking : Vehicle Lock LED and Ambient Led are OFF,
+ * HAZARD LED is Blinking for 2 times ( 0.5 sec high and 0.5 sec low ) for each blink */
+static void Door_Lock_Entry(void)
+{
+	Shadow_WriteMasked(GPIO_B, 0, VEHICLE_LOCK_LED_MASK);
+	AMBIENT_LIGHT_OFF();
+	HAZARD_LIGHT_BLINK(2);
+	SwTimer_Start(STATE_TIMER, BLINKING_TIME, 0, Timers_Expired);
+}
+
+/* Vehicle Door Unlocked and Door is Closed : VEHICLE LED and HAZARD LED ARE OFF */
+static void Closing_The_Door_Entry(void)
+{
+	SHADOW_PIN_WRITE(VEHICLE_LOCK_LED_PIN, LOW);
+	/* Ambient Led is ON for 1 second then OFF */
+	Pattern_Start(AMBIENT_PATTERN, &closing_light);
+	/* Start counting for 10 seconds If no buttons is pressed go to ANTI_THEFT_LOCK state */
+	SwTimer_Start(STATE_TIMER, CLOSING_TIME_OUT, 0, Timers_Expired);
+}
+
+/* The anti theft lock ends with the handle locked */
+static void Handle_Lock(void)
+{
+	handle_lock = DOOR_LOCKED;
+}
+
+/* Use cases actions, indexed by the use case */
+static const Fsm_StateType door_states[NUM_OF_USE_CASES] = {
+	/* Entry                   Exit            Do */
+	{ Default_Entry,           Use_Case_Exit,  0 },   /* DEFAULT_STATE */
+	{ Door_Unlock_Entry,       Use_Case_Exit,  0 },   /* DOOR_UNLOCK */
+	{ Door_Is_Open_Entry,      Use_Case_Exit,  0 },   /* DOOR_IS_OPEN */
+	{ Door_Lock_Entry,         Use_Case_Exit,  0 },   /* ANTI_THEFT_LOCK */
+	{ Closing_The_Door_Entry,  Use_Case_Exit,  0 },   /* CLOSING_THE_DOOR */
+	{ Door_Lock_Entry,         Use_Case_Exit,  0 },   /* LOCKING_THE_DOOR */
+};
+
+/* Use cases transitions : the first row of the use case for the event with a TRUE condition is taken,
+ * the buttons states are updated before their events are dispatched */
+static const Fsm_TransitionType door_transitions[] = {
+	/* Use case          Event             Condition          Action             Next use case */
+	{ DEFAULT_STATE,     HANDLE_PRESSED,   Handle_IsUnlocked, 0,                 DOOR_UNLOCK },
+
+	{ DOOR_UNLOCK,       FSM_COMPLETION,   Handle_IsLocked,   0,                 LOCKING_THE_DOOR },
+	{ DOOR_UNLOCK,       FSM_COMPLETION,   Door_IsOpened,     0,                 DOOR_IS_OPEN },
+	{ DOOR_UNLOCK,       STATE_TIME_OUT,   0,                 0,                 ANTI_THEFT_LOCK },
+	{ DOOR_UNLOCK,       DOOR_PRESSED,     Door_IsOpened,     0,                 DOOR_IS_OPEN },
+	{ DOOR_UNLOCK,       HANDLE_PRESSED,   Handle_IsLocked,   0,                 LOCKING_THE_DOOR },
+
+	{ DOOR_IS_OPEN,      DOOR_PRESSED,     Door_IsClosed,     0,                 CLOSING_THE_DOOR },
+
+	{ ANTI_THEFT_LOCK,   STATE_TIME_OUT,   0,                 Handle_Lock,       DEFAULT_STATE },
+
+	{ CLOSING_THE_DOOR,  FSM_COMPLETION,   Handle_IsLocked,   0,                 LOCKING_THE_DOOR },
+	{ CLOSING_THE_DOOR,  STATE_TIME_OUT,   0,                 0,                 ANTI_THEFT_LOCK },
+	{ CLOSING_THE_DOOR,  DOOR_PRESSED,     Door_IsOpened,     0,                 DOOR_IS_OPEN },
+	{ CLOSING_THE_DOOR,  HANDLE_PRESSED,   Handle_IsLocked,   0,                 LOCKING_THE_DOOR },
+
+	{ LOCKING_THE_DOOR,  STATE_TIME_OUT,   0,                 0,                 DEFAULT_STATE },
+	{ LOCKING_THE_DOOR,  HANDLE_PRESSED,   Handle_IsUnlocked, 0,                 DOOR_UNLOCK },
+};
+
+static Fsm_MachineType door_machine = {
+	.States = door_states,
+	.NumOfStates = NUM_OF_USE_CASES,
+	.Transitions = door_transitions,
+	.NumOfTransitions = sizeof(door_transitions) / sizeof(door_transitions[0]),
+	.Current = DEFAULT_STATE,
+};
+
+/*******************************************************************************
+ *                            Low Power Idle                                   *
+ *******************************************************************************/
+
+/* Sleep till the next interrupt (an interrupt that posted an event since the last check ends it at once) :
+ * Stop mode when no timer is needed (no software timer running, no button debouncing,
+ * no hazard blink and the ambient light fully OFF), else Sleep mode woken by the next timer deadline */
+static void Idle(void)
+{
+	if ((SwTimer_GetRunningCount() == 0) &&
+		(Debounce_IsBusy() == FALSE) &&
+		(Pwm_IsBlinking(HAZARD_LIGHT_TIMER, HAZARD_LIGHT_CHANNEL) == FALSE) &&
+		(Pwm_IsFading(AMBIENT_LIGHT_TIMER, AMBIENT_LIGHT_CHANNEL) == FALSE) &&
+		(Pwm_GetDuty(AMBIENT_LIGHT_TIMER, AMBIENT_LIGHT_CHANNEL) == PWM_DUTY_OFF))
+	{
+		Power_Idle(POWER_STOP);
+	}
+	else
+	{
+		Power_Idle(POWER_SLEEP);
+	}
+}
+
+/*******************************************************************************
+ *                            Events Handling                                  *
+ *******************************************************************************/
+
+/* Block till the next event : the core sleeps while the queue is empty */
+static void Wait_Event(EventQueue_EventType * Event)
+{
+	while (EventQueue_Get(Event) == FALSE)
+	{
+		Idle();
+	}
+}
+
+/* Run one event to completion by the door state machine : the outputs and the timers
+ * change only on the use cases transitions */
+static void Handle_Event(const EventQueue_EventType * Event)
+{
+	if ((Event->Type == EVENTQUEUE_BUTTON) && (Event->Level == BUTTON_PRESSED))
+	{
+		Buttons_Pressed(Event->Id);
+		(void)Fsm_Dispatch(&door_machine, (Event->Id == HANDLE_LOCK_BUTTON) ? HANDLE_PRESSED : DOOR_PRESSED);
+	}
+	/* the expiry of a timer stopped or restarted since its event is dropped,
+	 * the timers of the LED patterns only move their patterns to the next step */
+	else if ((Event->Type == EVENTQUEUE_TIMER) && SwTimer_CheckExpired(Event->Id) &&
+			 (Pattern_Step(Event->Id) == FALSE) && (Event->Id == STATE_TIMER))
+	{
+		(void)Fsm_Dispatch(&door_machine, STATE_TIME_OUT);
+	}
+}
+
+/* The reaction to an event ends when it is handled (a post since its start is measured from
+ * the start of the newer post) */
+static void End_Reaction(const EventQueue_EventType * Event)
+{
+	Latency_Stop((Event->Type == EVENTQUEUE_BUTTON) ? PROBE_BUTTON_REACTION : PROBE_TIMER_REACTION);
+}
 
 /*******************************************************************************
  *                                Main                                         *
  *******************************************************************************/
 int main()
 {
-	/*SET frequency to 1 MHz (set Prescaler to 16) */
-	RCC_CFGR |= (0x0B << 4);
-
 	/* ***********************Initializations*********************** */
 	/* Initialize RCC Driver */
 	Rcc_Init();
+	/* Core at 84 MHz, the timers prescalers are derived from the bus clocks (1 ms semantics kept) */
+	Rcc_ConfigClock(&clock_config);
+
+	/* Interrupts priorities : 16 preemption levels, set before any interrupt is enabled */
+	Nvic_SetPriorityGrouping(NVIC_GROUP_4_0);
+	Nvic_SetPriority(TIM4_IRQ_POSITION, LIGHTS_IRQ_PRIORITY, 0);
+	Nvic_SetPriority(TIM5_IRQ_POSITION, CLOCK_IRQ_PRIORITY, 0);
+	Nvic_SetPriority(TIM2_IRQ_POSITION, BUTTONS_IRQ_PRIORITY, 0);
+	Nvic_SetPriority(EXTI2_IRQ_POSITION, BUTTONS_IRQ_PRIORITY, 0);
+	Nvic_SetPriority(EXTI3_IRQ_POSITION, BUTTONS_IRQ_PRIORITY, 0);
+
+	/* Response times measured with the core cycle counter, the timers handlers included */
+	Latency_Init();
+	GPT_SetProbe(GPT_TIM2, PROBE_DEBOUNCE_TIMER);
+	GPT_SetProbe(GPT_TIM4, PROBE_LIGHTS_TIMER);
+	GPT_SetProbe(GPT_TIM5, PROBE_CLOCK_TIMER);
 
 	/* Enable Clock for System configuration controller */
 	Rcc_Enable(RCC_SYSCFG);
@@ -83,291 +455,60 @@ int main()
 	/* Initialize GPIO Driver */
 	Gpio_Init();
 
-	/* Initialize GPT TIMER*/
-	GPT_Init();
+	/* Initialize the low power idle */
+	Power_Init();
+
+	/* Events from the interrupts to the main loop */
+	EventQueue_Init();
+
+	/* Initialize the monotonic clock and the Software Timers */
+	GPT_ClockInit();
+	SwTimer_Init();
 
 	/* ***********************Configurations*********************** */
 
-	/*initialize interrupts for line 2 and line 3 from PORT A as Falling Edge (Input Push Buttons) */
-	Exti_Init(PORT_A,HANDLE_LOCK_BUTTON,FALLING_EDGE);
-	Exti_Init(PORT_A,DOOR_LOCK_BUTTON,FALLING_EDGE);
+	/*initialize interrupts for line 2 and line 3 from PORT A on both edges (Input Push Buttons),
+	 * the edges are debounced : a press is confirmed after BUTTON_DEBOUNCE_MS without bounce */
+	Exti_Init(PORT_A,HANDLE_LOCK_BUTTON,RISING_FALLING_EDGE);
+	Exti_Init(PORT_A,DOOR_LOCK_BUTTON,RISING_FALLING_EDGE);
+	Debounce_Init();
+	Debounce_ConfigLine(PORT_A, HANDLE_LOCK_BUTTON, BUTTON_DEBOUNCE_MS, Buttons_Debounced);
+	Debounce_ConfigLine(PORT_A, DOOR_LOCK_BUTTON, BUTTON_DEBOUNCE_MS, Buttons_Debounced);
+
+	/* The edges of the buttons go to the debounce service (EXTI2 / EXTI3 interrupts) */
+	Exti_SetHandler(HANDLE_LOCK_BUTTON, Buttons_Edge);
+	Exti_SetHandler(DOOR_LOCK_BUTTON, Buttons_Edge);
 
 	/* Enable interrupts */
 	Exti_Enable(HANDLE_LOCK_BUTTON);
 	Exti_Enable(DOOR_LOCK_BUTTON);
 
 	/* Configure pins for Output LEDS */
-	Gpio_ConfigPin(GPIO_B, VEHICLE_LOCK_LED, GPIO_OUTPUT, GPIO_PUSH_PULL, GPIO_PULL_UP);
-	Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, LOW);
-	Gpio_ConfigPin(GPIO_B, HAZARD_LIGHT_LED, GPIO_OUTPUT, GPIO_PUSH_PULL, GPIO_PULL_UP);
-	Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-	Gpio_ConfigPin(GPIO_B, AMBIENT_LIGHT_LED, GPIO_OUTPUT, GPIO_PUSH_PULL, GPIO_PULL_UP);
-	Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, LOW);
+	Gpio_ConfigPort(GPIO_B, leds_config, sizeof(leds_config) / sizeof(leds_config[0]));
+	/* All LEDs are OFF, LEDs are written only when their level changes */
+	Shadow_Init(GPIO_B, ALL_LEDS_MASK, 0);
+	/* Ambient Light LED PWM output, OFF */
+	Pwm_Init(AMBIENT_LIGHT_TIMER);
+	Pwm_ConfigChannel(AMBIENT_LIGHT_TIMER, AMBIENT_LIGHT_CHANNEL);
+	/* Hazard Light LED output on the same timer, OFF */
+	HAZARD_LIGHT_OFF();
 
-	while (1)
-	{
-		/*******************************************************************************
-		 *                            Vehicle   Cases                                  *
-		 *******************************************************************************/
+	/* LED patterns over the shadowed pins and the ambient light fades */
+	Pattern_Init(Leds_Output, Timers_Expired);
 
-		switch (use_case)
-		{
-		/* System is Powered ON
-		 * No Buttons is pressed */
-		case DEFAULT_STATE:
-			Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, LOW);
-			Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-			Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, LOW);
-
-			if (handle_lock == DOOR_UNLOCKED)
-			{
-				use_case = DOOR_UNLOCK;
-			}
-			break;
-			/* **************Vehicle Door Unlocked but still Closed *************/
-		case DOOR_UNLOCK:
-			/* Vehicle Lock LED is ON*/
-			Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, HIGH);
-
-			/*HAZARD LED is Blinking for one time ( 0.5 sec high and 0.5 sec low ) */
-			/* Ambient Light Led is on for 2 seconds */
-			/* Start counting for 10 seconds If no buttons is pressed go to ANTI_THEFT_LOCK state */
-			/* Check that timer did not started before to start the timer */
-			if ( GPT_CheckTimeIsElapsed() == TIMER_NOT_STARTED  )
-			{
-				/* Start timer for 10 seconds */
-				GPT_StartTimer(10000);
-			}
-
-			/* Timer Conditions */
-			/* If no overflow occurred blink LEDs */
-			if (g_overflow_flag == NO_OVERFLOW)
-			{
-				if (GPT_CheckTimeIsElapsed() == OVERFLOW)
-				{
-					/* if overflow occurs (10 seconds ended) close the LEDs and go to ANTI_THEFT_LOCK State */
-					use_case = ANTI_THEFT_LOCK;
-				}
-				else if( GPT_GetElapsedTime() < 500 )
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, HIGH);
-					Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, HIGH);
-				}
-				else if ((GPT_GetElapsedTime() >= 500) && (GPT_GetElapsedTime() < 1000))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-				}
-				else if (GPT_GetElapsedTime() >= 2000)
-				{
-					/* if 2 seconds ended close the leds */
-					Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, LOW);
-				}
-
-			}
-			/* if overflow occurs (10 seconds ended) close the LEDs and go to ANTI_THEFT_LOCK State */
-			else if (g_overflow_flag == OVERFLOW)
-			{
-				use_case = ANTI_THEFT_LOCK;
-			}
-
-			/* check buttons*/
-			if (door_lock == DOOR_OPENED)
-			{
-				GPT_EndTimer();
-				use_case = DOOR_IS_OPEN;
-			}
-			if (handle_lock == DOOR_LOCKED)
-			{
-				GPT_EndTimer();
-				use_case = LOCKING_THE_DOOR;
-			}
-			break;
-			/* **************** Vehicle Door Unlocked and Door is Open *******************/
-		case DOOR_IS_OPEN:
-			/* Ambient LED is ON*/
-			Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, HIGH);
-			Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, HIGH);
-			Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-
-			if (door_lock == DOOR_CLOSED)
-			{
-				use_case = CLOSING_THE_DOOR;
-			}
-			break;
-			/* **************** ANTI_THEFT_LOCK State *******************/
-		case ANTI_THEFT_LOCK:
-			/* Vehicle Lock LED is OFF*/
-			Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, LOW);
-			/* Ambient Led is OFF */
-			Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, LOW);
-			/*HAZARD LED is Blinking for 2 times ( 0.5 sec high and 0.5 sec low ) for each blink */
-			/* Check that timer did not started before to start the timer */
-			if ( GPT_CheckTimeIsElapsed() == TIMER_NOT_STARTED )
-			{
-				/* Start timer for 2 seconds */
-				GPT_StartTimer(2000);
-			}
-
-			/* Timer Conditions */
-			/* If no overflow occurred blink LEDS */
-			if (g_overflow_flag == NO_OVERFLOW)
-			{
-
-				if (GPT_CheckTimeIsElapsed() == OVERFLOW)
-				{
-					/* if overflow occurs (2 seconds ended) close the Leds and go to DEFAULT_STATE */
-					handle_lock = DOOR_LOCKED;
-					use_case = DEFAULT_STATE;
-				}
-				else if( GPT_GetElapsedTime() < 500 )
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, HIGH);
-				}
-				else if ((GPT_GetElapsedTime() > 500) && (GPT_GetElapsedTime() < 1000))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-				}
-				else if ((GPT_GetElapsedTime() >= 1000) && (GPT_GetElapsedTime() < 1500))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, HIGH);
-				}
-				else if ((GPT_GetElapsedTime() > 1500))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-				}
-			}
-			/* if overflow occurs (2 seconds ended) close the Leds and go to DEFAULT_STATE */
-			else if (g_overflow_flag == OVERFLOW)
-			{
-				handle_lock = DOOR_LOCKED;
-				use_case = DEFAULT_STATE;
-			}
-			break;
-			/* ***************** Vehicle Door Unlocked and Door is Closed *****************/
-		case CLOSING_THE_DOOR:
-			/* VEHICLE LED IS OFF */
-			Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, LOW);
-			/* HAZARD LED IS OFF */
-			Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-			/* Ambient Led is ON for 1 second then OFF */
-			/* Check that timer did not started before to start the timer */
-			if ( GPT_CheckTimeIsElapsed() == TIMER_NOT_STARTED )
-			{
-				/* Start timer for 10 seconds */
-				GPT_StartTimer(10000);
-			}
-			/* Timer Conditions */
-			if (g_overflow_flag == NO_OVERFLOW)
-			{
-				if (GPT_CheckTimeIsElapsed() == OVERFLOW)
-				{
-					/* if overflow occurs (10 seconds ended) go to ANTI_THEFT_LOCK state  */
-					use_case = ANTI_THEFT_LOCK;
-				}
-				else if( GPT_GetElapsedTime() < 1000 )
-				{
-					Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, HIGH);
-				}
-				else if ( (GPT_GetElapsedTime() >= 1000) )
-				{
-					Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, LOW);
-				}
-
-			}
-			else if (g_overflow_flag == OVERFLOW)
-			{
-				/* if overflow occurs (10 seconds ended) go to ANTI_THEFT_LOCK state  */
-				use_case = ANTI_THEFT_LOCK;
-			}
-			/* check buttons*/
-			if (door_lock == DOOR_OPENED)
-			{
-				GPT_EndTimer();
-				use_case = DOOR_IS_OPEN;
-			}
-			if (handle_lock == DOOR_LOCKED)
-			{
-				GPT_EndTimer();
-				use_case = LOCKING_THE_DOOR;
-			}
-			break;
-			/* ********************Vehicle Door Locked and Door is Closed******************* */
-		case LOCKING_THE_DOOR:
-			/* VEHICLE LED IS OFF */
-			Gpio_WritePinValue(GPIO_B, VEHICLE_LOCK_LED, LOW);
-			/* Ambient Led is OFF */
-			Gpio_WritePinValue(GPIO_B, AMBIENT_LIGHT_LED, LOW);
-			/*HAZARD LED is Blinking for 2 times */
-			/* Check that timer did not started before to start the timer */
-			if ( GPT_CheckTimeIsElapsed() == TIMER_NOT_STARTED )
-			{
-				/* Start timer for 2 seconds */
-				GPT_StartTimer(2000);
-			}
-
-			/* Timer Conditions */
-			/* If no overflow occurred blink LEDs */
-			if (g_overflow_flag == NO_OVERFLOW)
-			{
-				if (GPT_CheckTimeIsElapsed() == OVERFLOW)
-				{
-					/* if overflow occurs (2 seconds ended) close the LEDs and go to DEFAULT_STATE */
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-					use_case = DEFAULT_STATE;
-				}
-				else if( GPT_GetElapsedTime() < 500 )
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, HIGH);
-				}
-				else if ((GPT_GetElapsedTime() > 500) && (GPT_GetElapsedTime() < 1000))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-				}
-				else if ((GPT_GetElapsedTime() >= 1000) && (GPT_GetElapsedTime() < 1500))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, HIGH);
-				}
-				else if ((GPT_GetElapsedTime() > 1500))
-				{
-					Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-				}
-			}
-			/* if overflow occurs (2 seconds ended) close the LEDS and go to DEFAULT_STATE */
-			else if (g_overflow_flag == OVERFLOW)
-			{
-				Gpio_WritePinValue(GPIO_B, HAZARD_LIGHT_LED, LOW);
-				use_case = DEFAULT_STATE;
-			}
-			if (handle_lock == DOOR_UNLOCKED)
-			{
-				GPT_EndTimer();
-				use_case = DOOR_UNLOCK;
-			}
-			break;
-		default:
-			use_case = DEFAULT_STATE;
-			break;
-		}
-	}
-}
+	/* The door starts in the default use case (All LEDs are OFF) */
+	Fsm_Start(&door_machine, DEFAULT_STATE);
 
-void EXTI2_IRQHandler(void) {
-	/* Handle Lock Button Interrupt */
-	handle_lock = !handle_lock;
+	/* Idle / busy time of the event loop (Power_GetStats) */
+	Power_ClearStats();
 
-	//clear pending flag of LINE_2
-	Exti_ClearPendingFlag(LINE_2);
-}
+	/* The loop only runs when an event is posted (button press / release, timer expiry) */
+	while (1)
+	{
+		EventQueue_EventType event;
 
-void EXTI3_IRQHandler(void) {
-	/* Door Lock Button Interrupt*/
-	if (handle_lock == DOOR_UNLOCKED){
-		door_lock = !door_lock;
-	}
-	else if( (handle_lock == DOOR_LOCKED) && (door_lock == DOOR_OPENED ) ){
-		door_lock = !door_lock;
+		Wait_Event(&event);
+		Handle_Event(&event);
+		End_Reaction(&event);
 	}
-
-	//clear pending flag of LINE_3
-	Exti_ClearPendingFlag(LINE_3);
 }